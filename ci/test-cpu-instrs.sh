@@ -25,10 +25,34 @@ echo "########################################################################";
 pio run -e native
 if [ $? -ne 0 ]; then echo -e "${RED}\xe2\x9c\x96"; else echo -e "${GREEN}\xe2\x9c\x93"; fi
 
+for core in accurate fast; do
+    echo -e "\n########################################################################";
+    echo -e "${YELLOW}RUN TEST ON THE ${core^^} CORE"
+    echo "########################################################################";
+    .pio/build/native/program 0 70000000 --core=$core | tee test.out
+    if grep -q "Passed all tests" test.out; then 
+        echo -e "${GREEN}\xe2\x9c\x93";
+    else
+        echo -e "${RED}\xe2\x9c\x96"; 
+        exit 1;
+    fi
+done
+
+echo -e "\n########################################################################";
+echo -e "${YELLOW}RUN TEST WITH THE ROM LOADED FROM THE SD CARD"
+echo "########################################################################";
+.pio/build/native/program 0 70000000 --sd | tee test.out
+if grep -q "Passed all tests" test.out; then 
+    echo -e "${GREEN}\xe2\x9c\x93";
+else
+    echo -e "${RED}\xe2\x9c\x96"; 
+    exit 1;
+fi
+
 echo -e "\n########################################################################";
-echo -e "${YELLOW}RUN TEST"
+echo -e "${YELLOW}RUN TEST WITH ROM BANKS PAGED IN FROM THE SD CARD"
 echo "########################################################################";
-.pio/build/native/program 0 70000000 | tee test.out
+.pio/build/native/program 0 70000000 --sd --rom-frames=3 | tee test.out
 if grep -q "Passed all tests" test.out; then 
     echo -e "${GREEN}\xe2\x9c\x93";
 else
@@ -71,16 +71,16 @@ void APU::begin() {
 }
 
 void APU::apuStep() {
-    const nr52_register_t nr52 = {.value = Memory::readByte(MEM_SOUND_NR52)};
+    const nr52_register_t nr52 = {.value = Memory::readByteInternal(MEM_SOUND_NR52)};
 
     if (nr52.bits.masterSwitch) {
         // Calculate frequencies
-        const nrx4_register_t nr14 = {.value = Memory::readByte(MEM_SOUND_NR14)};
-        const nrx4_register_t nr24 = {.value = Memory::readByte(MEM_SOUND_NR24)};
-        const nrx4_register_t nr34 = {.value = Memory::readByte(MEM_SOUND_NR34)};
-        const uint16_t frequency[] = {(uint16_t)(0x20000 / (0x800 - ((nr14.bits.frequency << 8) | Memory::readByte(MEM_SOUND_NR13)))),
-                                      (uint16_t)(0x20000 / (0x800 - ((nr24.bits.frequency << 8) | Memory::readByte(MEM_SOUND_NR23)))),
-                                      (uint16_t)(0x10000 / (0x800 - ((nr34.bits.frequency << 8) | Memory::readByte(MEM_SOUND_NR33))))};
+        const nrx4_register_t nr14 = {.value = Memory::readByteInternal(MEM_SOUND_NR14)};
+        const nrx4_register_t nr24 = {.value = Memory::readByteInternal(MEM_SOUND_NR24)};
+        const nrx4_register_t nr34 = {.value = Memory::readByteInternal(MEM_SOUND_NR34)};
+        const uint16_t frequency[] = {(uint16_t)(0x20000 / (0x800 - ((nr14.bits.frequency << 8) | Memory::readByteInternal(MEM_SOUND_NR13)))),
+                                      (uint16_t)(0x20000 / (0x800 - ((nr24.bits.frequency << 8) | Memory::readByteInternal(MEM_SOUND_NR23)))),
+                                      (uint16_t)(0x10000 / (0x800 - ((nr34.bits.frequency << 8) | Memory::readByteInternal(MEM_SOUND_NR33))))};
 
         for (uint8_t i = 0; i < 3; i++) {
             if (APU::currentFrequency[i] != frequency[i] && frequency[i] != 0) {
@@ -89,7 +89,7 @@ void APU::apuStep() {
             }
         }
 
-        const nr43_register_t nr43 = {.value = Memory::readByte(MEM_SOUND_NR43)};
+        const nr43_register_t nr43 = {.value = Memory::readByteInternal(MEM_SOUND_NR43)};
         const uint16_t noiseFreq = 0x80000 / APU::divisor[nr43.bits.divisor] / (1 << (nr43.bits.shift + 1));
 
         if (APU::currentFrequency[Channel::noise] != noiseFreq && noiseFreq != 0) {
@@ -109,13 +109,13 @@ void APU::apuStep() {
 }
 
 void APU::squareUpdate1() {
-    const nrx1_register_t nrx1 = {.value = Memory::readByte(MEM_SOUND_NR11)};
-    const nrx4_register_t nrx4 = {.value = Memory::readByte(MEM_SOUND_NR14)};
+    const nrx1_register_t nrx1 = {.value = Memory::readByteInternal(MEM_SOUND_NR11)};
+    const nrx4_register_t nrx4 = {.value = Memory::readByteInternal(MEM_SOUND_NR14)};
 
     if (APU::dacEnabled[Channel::square1] && APU::channelEnabled[Channel::square1] && (!nrx4.bits.lengthEnable || APU::lengthCounter[Channel::square1] > 0)) {
-        const nrx2_register_t envelope = {.value = Memory::readByte(MEM_SOUND_NR12)};
-        const nr50_register_t channelControl = {.value = Memory::readByte(MEM_SOUND_NR50)};
-        const nr51_register_t terminalControl = {.value = Memory::readByte(MEM_SOUND_NR51)};
+        const nrx2_register_t envelope = {.value = Memory::readByteInternal(MEM_SOUND_NR12)};
+        const nr50_register_t channelControl = {.value = Memory::readByteInternal(MEM_SOUND_NR50)};
+        const nr51_register_t terminalControl = {.value = Memory::readByteInternal(MEM_SOUND_NR51)};
         const uint8_t mixerVolume = (channelControl.bits.terminal1Volume * terminalControl.bits.square1Terminal1 +
                                      channelControl.bits.terminal2Volume * terminalControl.bits.square1Terminal2) /
                                     (terminalControl.bits.square1Terminal1 + terminalControl.bits.square1Terminal2);
@@ -128,13 +128,13 @@ void APU::squareUpdate1() {
 }
 
 void APU::squareUpdate2() {
-    const nrx1_register_t nrx1 = {.value = Memory::readByte(MEM_SOUND_NR21)};
-    const nrx4_register_t nrx4 = {.value = Memory::readByte(MEM_SOUND_NR24)};
+    const nrx1_register_t nrx1 = {.value = Memory::readByteInternal(MEM_SOUND_NR21)};
+    const nrx4_register_t nrx4 = {.value = Memory::readByteInternal(MEM_SOUND_NR24)};
 
     if (APU::dacEnabled[Channel::square2] && APU::channelEnabled[Channel::square2] && (!nrx4.bits.lengthEnable || APU::lengthCounter[Channel::square2] > 0)) {
-        const nrx2_register_t envelope = {.value = Memory::readByte(MEM_SOUND_NR22)};
-        const nr50_register_t channelControl = {.value = Memory::readByte(MEM_SOUND_NR50)};
-        const nr51_register_t terminalControl = {.value = Memory::readByte(MEM_SOUND_NR51)};
+        const nrx2_register_t envelope = {.value = Memory::readByteInternal(MEM_SOUND_NR22)};
+        const nr50_register_t channelControl = {.value = Memory::readByteInternal(MEM_SOUND_NR50)};
+        const nr51_register_t terminalControl = {.value = Memory::readByteInternal(MEM_SOUND_NR51)};
         const uint8_t mixerVolume = (channelControl.bits.terminal1Volume * terminalControl.bits.square2Terminal1 +
                                      channelControl.bits.terminal2Volume * terminalControl.bits.square2Terminal2) /
                                     (terminalControl.bits.square2Terminal1 + terminalControl.bits.square2Terminal2);
@@ -147,15 +147,15 @@ void APU::squareUpdate2() {
 }
 
 void APU::waveUpdate() {
-    const nrx4_register_t nrx4 = {.value = Memory::readByte(MEM_SOUND_NR34)};
+    const nrx4_register_t nrx4 = {.value = Memory::readByteInternal(MEM_SOUND_NR34)};
 
     if (APU::dacEnabled[Channel::wave] && APU::channelEnabled[Channel::wave] && (!nrx4.bits.lengthEnable || APU::lengthCounter[Channel::wave] > 0)) {
-        const uint8_t volumeShift = (Memory::readByte(MEM_SOUND_NR32) >> 5) & 0x3;
-        const uint8_t waveByte = Memory::readByte(MEM_SOUND_WAVE_START + APU::dutyStep[Channel::wave] / 2);
+        const uint8_t volumeShift = (Memory::readByteInternal(MEM_SOUND_NR32) >> 5) & 0x3;
+        const uint8_t waveByte = Memory::readByteInternal(MEM_SOUND_WAVE_START + APU::dutyStep[Channel::wave] / 2);
         const uint8_t waveNibble = (waveByte >> (4 * (1 - (APU::dutyStep[Channel::wave] % 2)))) & 0xF;
 
-        const nr50_register_t channelControl = {.value = Memory::readByte(MEM_SOUND_NR50)};
-        const nr51_register_t terminalControl = {.value = Memory::readByte(MEM_SOUND_NR51)};
+        const nr50_register_t channelControl = {.value = Memory::readByteInternal(MEM_SOUND_NR50)};
+        const nr51_register_t terminalControl = {.value = Memory::readByteInternal(MEM_SOUND_NR51)};
         const uint8_t mixerVolume = (channelControl.bits.terminal1Volume * terminalControl.bits.waveTerminal1 +
                                      channelControl.bits.terminal2Volume * terminalControl.bits.waveTerminal2) /
                                     (terminalControl.bits.waveTerminal1 + terminalControl.bits.waveTerminal2);
@@ -168,10 +168,10 @@ void APU::waveUpdate() {
 }
 
 void APU::noiseUpdate() {
-    const nrx4_register_t nrx4 = {.value = Memory::readByte(MEM_SOUND_NR44)};
+    const nrx4_register_t nrx4 = {.value = Memory::readByteInternal(MEM_SOUND_NR44)};
 
     if (APU::dacEnabled[Channel::noise] && APU::channelEnabled[Channel::noise] && (!nrx4.bits.lengthEnable || APU::lengthCounter[Channel::noise] > 0)) {
-        const nr43_register_t nr43 = {.value = Memory::readByte(MEM_SOUND_NR43)};
+        const nr43_register_t nr43 = {.value = Memory::readByteInternal(MEM_SOUND_NR43)};
 
         const bool xorBit = (APU::noiseRegister >> 1 & 0x1) ^ (APU::noiseRegister & 0x1);
         APU::noiseRegister = (APU::noiseRegister >> 1) | (xorBit << 14);
@@ -180,9 +180,9 @@ void APU::noiseUpdate() {
             APU::noiseRegister = (APU::noiseRegister & 0xFFBF) | (xorBit << 6);
         }
 
-        const nrx2_register_t envelope = {.value = Memory::readByte(MEM_SOUND_NR42)};
-        const nr50_register_t channelControl = {.value = Memory::readByte(MEM_SOUND_NR50)};
-        const nr51_register_t terminalControl = {.value = Memory::readByte(MEM_SOUND_NR51)};
+        const nrx2_register_t envelope = {.value = Memory::readByteInternal(MEM_SOUND_NR42)};
+        const nr50_register_t channelControl = {.value = Memory::readByteInternal(MEM_SOUND_NR50)};
+        const nr51_register_t terminalControl = {.value = Memory::readByteInternal(MEM_SOUND_NR51)};
         const uint8_t mixerVolume = (channelControl.bits.terminal1Volume * terminalControl.bits.noiseTerminal1 +
                                      channelControl.bits.terminal2Volume * terminalControl.bits.noiseTerminal2) /
                                     (terminalControl.bits.noiseTerminal1 + terminalControl.bits.noiseTerminal2);
@@ -198,28 +198,28 @@ void APU::effectUpdate() {
 
     // Length update
     {
-        const nrx4_register_t nrx4 = {.value = Memory::readByte(MEM_SOUND_NR14)};
+        const nrx4_register_t nrx4 = {.value = Memory::readByteInternal(MEM_SOUND_NR14)};
         if (nrx4.bits.lengthEnable && APU::lengthCounter[Channel::square1] != 0) {
             APU::lengthCounter[Channel::square1]--;
         }
     }
 
     {
-        const nrx4_register_t nrx4 = {.value = Memory::readByte(MEM_SOUND_NR24)};
+        const nrx4_register_t nrx4 = {.value = Memory::readByteInternal(MEM_SOUND_NR24)};
         if (nrx4.bits.lengthEnable && APU::lengthCounter[Channel::square2] != 0) {
             APU::lengthCounter[Channel::square2]--;
         }
     }
 
     {
-        const nrx4_register_t nrx4 = {.value = Memory::readByte(MEM_SOUND_NR34)};
+        const nrx4_register_t nrx4 = {.value = Memory::readByteInternal(MEM_SOUND_NR34)};
         if (nrx4.bits.lengthEnable && APU::lengthCounter[Channel::wave] != 0) {
             APU::lengthCounter[Channel::wave]--;
         }
     }
 
     {
-        const nrx4_register_t nrx4 = {.value = Memory::readByte(MEM_SOUND_NR44)};
+        const nrx4_register_t nrx4 = {.value = Memory::readByteInternal(MEM_SOUND_NR44)};
         if (nrx4.bits.lengthEnable && APU::lengthCounter[Channel::noise] != 0) {
             APU::lengthCounter[Channel::noise]--;
         }
@@ -227,7 +227,7 @@ void APU::effectUpdate() {
 
     if ((APU::effectTimerCounter % 2) == 0) {
         // Sweep update
-        const nr10_register_t nr10 = {.value = Memory::readByte(MEM_SOUND_NR10)};
+        const nr10_register_t nr10 = {.value = Memory::readByteInternal(MEM_SOUND_NR10)};
 
         if (nr10.bits.time != 0 && nr10.bits.shift != 0) {
             APU::sweepStep++;
@@ -237,7 +237,7 @@ void APU::effectUpdate() {
                 if (newFrequency > 0 && newFrequency < 0x7FF) {
                     APU::sweepFrequency = newFrequency;
                     Memory::writeByteInternal(MEM_SOUND_NR13, newFrequency & 0xF, true);
-                    Memory::writeByteInternal(MEM_SOUND_NR14, ((newFrequency >> 8) & 0x3) | (Memory::readByte(MEM_SOUND_NR14) & 0xFC), true);
+                    Memory::writeByteInternal(MEM_SOUND_NR14, ((newFrequency >> 8) & 0x3) | (Memory::readByteInternal(MEM_SOUND_NR14) & 0xFC), true);
                 }
             }
         }
@@ -247,7 +247,7 @@ void APU::effectUpdate() {
         // Envelope update
         {
             APU::envelopeStep[Channel::square1]++;
-            const nrx2_register_t envelope = {.value = Memory::readByte(MEM_SOUND_NR12)};
+            const nrx2_register_t envelope = {.value = Memory::readByteInternal(MEM_SOUND_NR12)};
 
             if (APU::envelopeStep[Channel::square1] % envelope.bits.period == 0) {
                 if (envelope.bits.direction && envelope.bits.volume < 0xF) {
@@ -263,7 +263,7 @@ void APU::effectUpdate() {
         }
         {
             APU::envelopeStep[Channel::square2]++;
-            const nrx2_register_t envelope = {.value = Memory::readByte(MEM_SOUND_NR22)};
+            const nrx2_register_t envelope = {.value = Memory::readByteInternal(MEM_SOUND_NR22)};
 
             if (APU::envelopeStep[Channel::square2] % envelope.bits.period == 0) {
                 if (envelope.bits.direction && envelope.bits.volume < 0xF) {
@@ -279,7 +279,7 @@ void APU::effectUpdate() {
         }
         {
             APU::envelopeStep[Channel::noise]++;
-            const nrx2_register_t envelope = {.value = Memory::readByte(MEM_SOUND_NR42)};
+            const nrx2_register_t envelope = {.value = Memory::readByteInternal(MEM_SOUND_NR42)};
 
             if (APU::envelopeStep[Channel::noise] % envelope.bits.period == 0) {
                 if (envelope.bits.direction && envelope.bits.volume < 0xF) {
@@ -297,12 +297,12 @@ void APU::effectUpdate() {
 }
 
 void APU::triggerSquare1() {
-    const nrx4_register_t nr14 = {.value = Memory::readByte(MEM_SOUND_NR14)};
+    const nrx4_register_t nr14 = {.value = Memory::readByteInternal(MEM_SOUND_NR14)};
 
     APU::envelopeStep[Channel::square1] = 0;
     APU::channelEnabled[Channel::square1] = APU::dacEnabled[Channel::square1];
     APU::sweepStep = 0;
-    APU::sweepFrequency = (uint16_t)(0x20000 / (0x800 - ((nr14.bits.frequency << 8) | Memory::readByte(MEM_SOUND_NR13))));
+    APU::sweepFrequency = (uint16_t)(0x20000 / (0x800 - ((nr14.bits.frequency << 8) | Memory::readByteInternal(MEM_SOUND_NR13))));
 }
 
 void APU::triggerSquare2() {
@@ -322,22 +322,22 @@ void APU::triggerNoise() {
 }
 
 void APU::loadLength1() {
-    const nrx1_register_t nrx1 = {.value = Memory::readByte(MEM_SOUND_NR11)};
+    const nrx1_register_t nrx1 = {.value = Memory::readByteInternal(MEM_SOUND_NR11)};
     APU::lengthCounter[Channel::square1] = 0x40 - nrx1.bits.length;
 }
 
 void APU::loadLength2() {
-    const nrx1_register_t nrx1 = {.value = Memory::readByte(MEM_SOUND_NR21)};
+    const nrx1_register_t nrx1 = {.value = Memory::readByteInternal(MEM_SOUND_NR21)};
     APU::lengthCounter[Channel::square2] = 0x40 - nrx1.bits.length;
 }
 
 void APU::loadLength3() {
-    const uint8_t length = Memory::readByte(MEM_SOUND_NR31);
+    const uint8_t length = Memory::readByteInternal(MEM_SOUND_NR31);
     APU::lengthCounter[Channel::wave] = 0x100 - length;
 }
 
 void APU::loadLength4() {
-    const nrx1_register_t nrx1 = {.value = Memory::readByte(MEM_SOUND_NR41)};
+    const nrx1_register_t nrx1 = {.value = Memory::readByteInternal(MEM_SOUND_NR41)};
     APU::lengthCounter[Channel::noise] = 0x40 - nrx1.bits.length;
 }
 
@@ -0,0 +1,58 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#pragma once
+
+/**
+ * Accuracy tiers
+ *
+ * CPU, Memory and PPU stepping are templates on one of these policies.
+ * Every tier is compiled into its own instantiation, so all checks on
+ * the policy constants are resolved at compile time.
+ */
+
+// Maximum speed, used on the Teensy
+struct FastCore {
+    static const char* name() { return "fast"; }
+
+    // Update the timer on every memory access (M-cycle) instead of once
+    // at the start of the next instruction
+    static const bool timedMemory = false;
+
+    // Transfer OAM DMA one byte per cycle and lock the CPU out of
+    // everything but I/O and High RAM, instead of a single block copy
+    static const bool timedDma = false;
+
+    // Only request LCD STAT interrupts on rising edges of the combined
+    // STAT interrupt line, instead of once for every enabled source
+    static const bool statIrqBlocking = false;
+
+    // Lock the CPU out of OAM during PPU mode 2 and out of OAM and VRAM
+    // during mode 3. Locked memory reads 0xFF and ignores writes
+    static const bool videoMemoryLocking = false;
+};
+
+// Hardware accurate timing, used by host test runs
+struct AccurateCore {
+    static const char* name() { return "accurate"; }
+
+    static const bool timedMemory = true;
+    static const bool timedDma = true;
+    static const bool statIrqBlocking = true;
+    static const bool videoMemoryLocking = true;
+};
@@ -22,6 +22,7 @@
 #include <Timer.h>
 #include <time.h>
 
+#include "Debugger.h"
 #include "Memory.h"
 
 /**
@@ -145,6 +146,8 @@ uint8_t CPU::timerCycles = 0, CPU::timerTotalCycles = 0xFF;
 
 uint8_t CPU::cyclesDelta = 0;
 
+uint8_t CPU::stepCycles = 0;
+
 #ifdef DEBUG_AFTER_CYCLE
 uint64_t debugAfterCycle = DEBUG_AFTER_CYCLE;
 #endif
@@ -153,25 +156,66 @@ uint64_t debugAfterCycle = DEBUG_AFTER_CYCLE;
  * Functions
  */
 
+template <typename Core>
+void CPU::tick() {
+    /**
+     * Run a single machine cycle of the timer and OAM DMA
+     * Only used by cores with timed memory access
+     */
+    stepCycles++;
+    GBTimer::timerStep();
+    if (Core::timedDma) {
+        Memory::dmaStep(1);
+    }
+}
+
+template <typename Core>
+uint8_t CPU::busRead(const uint16_t location) {
+    /**
+     * Read a byte from memory
+     * Every memory access takes one machine cycle
+     * @return The byte at location
+     */
+    if (Core::timedMemory) {
+        tick<Core>();
+    }
+    return Memory::readByte(location);
+}
+
+template <typename Core>
+void CPU::busWrite(const uint16_t location, const uint8_t data) {
+    /**
+     * Write a byte to memory
+     * Every memory access takes one machine cycle
+     */
+    if (Core::timedMemory) {
+        tick<Core>();
+    }
+    Memory::writeByte(location, data);
+}
+
+template <typename Core>
 uint8_t CPU::readOp() {
     /**
      * Read an opcode from the program
      * @return An 8 byte opcode
      */
-    return Memory::readByte(PC++);
+    return busRead<Core>(PC++);
 }
 
+template <typename Core>
 uint16_t CPU::readNn() {
     /**
      * Read program data from where PC is currently pointing
      * Advances PC by two
      * @return Two bytes of big endian program data
      */
-    uint8_t n1 = Memory::readByte(PC++);
-    uint8_t n2 = Memory::readByte(PC++);
+    uint8_t n1 = busRead<Core>(PC++);
+    uint8_t n2 = busRead<Core>(PC++);
     return n1 | (n2 << 8);
 }
 
+template <typename Core>
 void CPU::pushStack(const uint16_t data) {
     /**
      * Push 16 bits of data to the stack, high byte first
@@ -179,20 +223,21 @@ void CPU::pushStack(const uint16_t data) {
      * @param data: The data to push to the stack
      */
     SP--;
-    Memory::writeByte(SP, data >> 8);
+    busWrite<Core>(SP, data >> 8);
     SP--;
-    Memory::writeByte(SP, data & 0x00FF);
+    busWrite<Core>(SP, data & 0x00FF);
 }
 
+template <typename Core>
 uint16_t CPU::popStack() {
     /**
      * Pop 16 bits of data from the stack
      * Increases SP by two
      * @return 16 bits of stack data.
      */
-    uint8_t n1 = Memory::readByte(SP);
+    uint8_t n1 = busRead<Core>(SP);
     SP++;
-    uint8_t n2 = Memory::readByte(SP);
+    uint8_t n2 = busRead<Core>(SP);
     SP++;
     return (n2 << 8) | n1;
 }
@@ -226,6 +271,7 @@ void CPU::stopAndRestart() {
     }
 }
 
+template <typename Core>
 void CPU::cpuStep() {
     /**
      * Perform one CPU operation
@@ -274,38 +320,45 @@ void CPU::cpuStep() {
     }
 #endif
 
-    // Update timer
-    for (uint8_t i = 0; i < cyclesDelta; i++) {
-        GBTimer::timerStep();
+    // Catch up with the previous instruction, unless the timer and OAM DMA
+    // have already been updated on every memory access
+    if (!Core::timedMemory) {
+        for (uint8_t i = 0; i < cyclesDelta; i++) {
+            GBTimer::timerStep();
+        }
+        if (Core::timedDma) {
+            Memory::dmaStep(cyclesDelta);
+        }
     }
+    stepCycles = 0;
 
     // Check for interrupts
     // Only service interrupts when IME is enabled or the CPU is halted
     if (IME || halted) {
-        interrupt = Memory::readByte(MEM_IRQ_FLAG) & Memory::readByte(MEM_IRQ_ENABLE) & 0x1F;
+        interrupt = Memory::readByteInternal(MEM_IRQ_FLAG) & Memory::readByteInternal(MEM_IRQ_ENABLE) & 0x1F;
 
         if (interrupt) {
             if (IME && !halted) {
                 IME = 0;
                 if ((interrupt & IRQ_VBLANK) == IRQ_VBLANK) {
-                    Memory::writeByte(MEM_IRQ_FLAG, Memory::readByte(MEM_IRQ_FLAG) & (0xFF - IRQ_VBLANK));
-                    pushStack(PC);
+                    Memory::writeByteInternal(MEM_IRQ_FLAG, Memory::readByteInternal(MEM_IRQ_FLAG) & (0xFF - IRQ_VBLANK), false);
+                    pushStack<Core>(PC);
                     PC = PC_VBLANK;
                 } else if ((interrupt & IRQ_LCD_STAT) == IRQ_LCD_STAT) {
-                    Memory::writeByte(MEM_IRQ_FLAG, Memory::readByte(MEM_IRQ_FLAG) & (0xFF - IRQ_LCD_STAT));
-                    pushStack(PC);
+                    Memory::writeByteInternal(MEM_IRQ_FLAG, Memory::readByteInternal(MEM_IRQ_FLAG) & (0xFF - IRQ_LCD_STAT), false);
+                    pushStack<Core>(PC);
                     PC = PC_LCD_STAT;
                 } else if ((interrupt & IRQ_TIMER) == IRQ_TIMER) {
-                    Memory::writeByte(MEM_IRQ_FLAG, Memory::readByte(MEM_IRQ_FLAG) & (0xFF - IRQ_TIMER));
-                    pushStack(PC);
+                    Memory::writeByteInternal(MEM_IRQ_FLAG, Memory::readByteInternal(MEM_IRQ_FLAG) & (0xFF - IRQ_TIMER), false);
+                    pushStack<Core>(PC);
                     PC = PC_TIMER;
                 } else if ((interrupt & IRQ_SERIAL) == IRQ_SERIAL) {
-                    Memory::writeByte(MEM_IRQ_FLAG, Memory::readByte(MEM_IRQ_FLAG) & (0xFF - IRQ_SERIAL));
-                    pushStack(PC);
+                    Memory::writeByteInternal(MEM_IRQ_FLAG, Memory::readByteInternal(MEM_IRQ_FLAG) & (0xFF - IRQ_SERIAL), false);
+                    pushStack<Core>(PC);
                     PC = PC_SERIAL;
                 } else if ((interrupt & IRQ_JOYPAD) == IRQ_JOYPAD) {
-                    Memory::writeByte(MEM_IRQ_FLAG, Memory::readByte(MEM_IRQ_FLAG) & (0xFF - IRQ_JOYPAD));
-                    pushStack(PC);
+                    Memory::writeByteInternal(MEM_IRQ_FLAG, Memory::readByteInternal(MEM_IRQ_FLAG) & (0xFF - IRQ_JOYPAD), false);
+                    pushStack<Core>(PC);
                     PC = PC_JOYPAD;
                 }
             }
@@ -316,17 +369,27 @@ void CPU::cpuStep() {
     // Check if halted
     if (halted) {
         cyclesDelta = 1;  // In order for the timer to work properly
+        if (Core::timedMemory) {
+            while (stepCycles < cyclesDelta) {
+                tick<Core>();
+            }
+            cyclesDelta = stepCycles;
+        }
         totalCycles += cyclesDelta;
         return;
     }
 
+    if (Debugger::breakpointsEnabled) {
+        Debugger::checkBreakpoint(PC);
+    }
+
 #ifdef DEBUG_AFTER_PC
     if (PC == DEBUG_AFTER_PC && debugAfterCycle == 0) {
         debugAfterCycle = totalCycles;
     }
 #endif
 
-    op = readOp();
+    op = readOp<Core>();
 
 #ifdef DEBUG_AFTER_CYCLE
     if (debugAfterCycle >= 0 && totalCycles >= debugAfterCycle) {
@@ -354,7 +417,7 @@ void CPU::cpuStep() {
         // Halt the CPU until button pressed
         // TODO: implement correctly
         case 0x10:
-            readOp();
+            readOp<Core>();
             cyclesDelta = 1;
             break;
 
@@ -367,27 +430,27 @@ void CPU::cpuStep() {
 
         // LD nn,n
         case 0x06:
-            BC = LD_Nn_n(BC, readOp());
+            BC = LD_Nn_n(BC, readOp<Core>());
             cyclesDelta = 2;
             break;
         case 0x0E:
-            BC = LD_nN_n(BC, readOp());
+            BC = LD_nN_n(BC, readOp<Core>());
             cyclesDelta = 2;
             break;
         case 0x16:
-            DE = LD_Nn_n(DE, readOp());
+            DE = LD_Nn_n(DE, readOp<Core>());
             cyclesDelta = 2;
             break;
         case 0x1E:
-            DE = LD_nN_n(DE, readOp());
+            DE = LD_nN_n(DE, readOp<Core>());
             cyclesDelta = 2;
             break;
         case 0x26:
-            HL = LD_Nn_n(HL, readOp());
+            HL = LD_Nn_n(HL, readOp<Core>());
             cyclesDelta = 2;
             break;
         case 0x2E:
-            HL = LD_nN_n(HL, readOp());
+            HL = LD_nN_n(HL, readOp<Core>());
             cyclesDelta = 2;
             break;
 
@@ -421,7 +484,7 @@ void CPU::cpuStep() {
             cyclesDelta = 1;
             break;
         case 0x7E:
-            AF = LD_Nn_nN(AF, Memory::readByte(HL));
+            AF = LD_Nn_nN(AF, busRead<Core>(HL));
             cyclesDelta = 2;
             break;
         case 0x40:
@@ -449,7 +512,7 @@ void CPU::cpuStep() {
             cyclesDelta = 1;
             break;
         case 0x46:
-            BC = LD_Nn_nN(BC, Memory::readByte(HL));
+            BC = LD_Nn_nN(BC, busRead<Core>(HL));
             cyclesDelta = 2;
             break;
         case 0x48:
@@ -477,7 +540,7 @@ void CPU::cpuStep() {
             cyclesDelta = 1;
             break;
         case 0x4E:
-            BC = LD_nN_nN(BC, Memory::readByte(HL));
+            BC = LD_nN_nN(BC, busRead<Core>(HL));
             cyclesDelta = 2;
             break;
         case 0x50:
@@ -505,7 +568,7 @@ void CPU::cpuStep() {
             cyclesDelta = 1;
             break;
         case 0x56:
-            DE = LD_Nn_nN(DE, Memory::readByte(HL));
+            DE = LD_Nn_nN(DE, busRead<Core>(HL));
             cyclesDelta = 2;
             break;
         case 0x58:
@@ -533,7 +596,7 @@ void CPU::cpuStep() {
             cyclesDelta = 1;
             break;
         case 0x5E:
-            DE = LD_nN_nN(DE, Memory::readByte(HL));
+            DE = LD_nN_nN(DE, busRead<Core>(HL));
             cyclesDelta = 2;
             break;
         case 0x60:
@@ -561,7 +624,7 @@ void CPU::cpuStep() {
             cyclesDelta = 1;
             break;
         case 0x66:
-            HL = LD_Nn_nN(HL, Memory::readByte(HL));
+            HL = LD_Nn_nN(HL, busRead<Core>(HL));
             cyclesDelta = 2;
             break;
         case 0x68:
@@ -589,53 +652,53 @@ void CPU::cpuStep() {
             cyclesDelta = 1;
             break;
         case 0x6E:
-            HL = LD_nN_nN(HL, Memory::readByte(HL));
+            HL = LD_nN_nN(HL, busRead<Core>(HL));
             cyclesDelta = 2;
             break;
         case 0x70:
-            Memory::writeByte(HL, BC >> 8);
+            busWrite<Core>(HL, BC >> 8);
             cyclesDelta = 2;
             break;
         case 0x71:
-            Memory::writeByte(HL, BC & 0x00FF);
+            busWrite<Core>(HL, BC & 0x00FF);
             cyclesDelta = 2;
             break;
         case 0x72:
-            Memory::writeByte(HL, DE >> 8);
+            busWrite<Core>(HL, DE >> 8);
             cyclesDelta = 2;
             break;
         case 0x73:
-            Memory::writeByte(HL, DE & 0x00FF);
+            busWrite<Core>(HL, DE & 0x00FF);
             cyclesDelta = 2;
             break;
         case 0x74:
-            Memory::writeByte(HL, HL >> 8);
+            busWrite<Core>(HL, HL >> 8);
             cyclesDelta = 2;
             break;
         case 0x75:
-            Memory::writeByte(HL, HL & 0x00FF);
+            busWrite<Core>(HL, HL & 0x00FF);
             cyclesDelta = 2;
             break;
         case 0x36:
-            Memory::writeByte(HL, readOp());
+            busWrite<Core>(HL, readOp<Core>());
             cyclesDelta = 3;
             break;
 
         // LD A,n
         case 0x0A:
-            AF = LD_Nn_nN(AF, Memory::readByte(BC));
+            AF = LD_Nn_nN(AF, busRead<Core>(BC));
             cyclesDelta = 2;
             break;
         case 0x1A:
-            AF = LD_Nn_nN(AF, Memory::readByte(DE));
+            AF = LD_Nn_nN(AF, busRead<Core>(DE));
             cyclesDelta = 2;
             break;
         case 0xFA:
-            AF = LD_Nn_nN(AF, Memory::readByte(readNn()));
+            AF = LD_Nn_nN(AF, busRead<Core>(readNn<Core>()));
             cyclesDelta = 4;
             break;
         case 0x3E:
-            AF = LD_Nn_nN(AF, readOp());
+            AF = LD_Nn_nN(AF, readOp<Core>());
             cyclesDelta = 2;
             break;
 
@@ -665,89 +728,89 @@ void CPU::cpuStep() {
             cyclesDelta = 1;
             break;
         case 0x02:
-            Memory::writeByte(BC, AF >> 8);
+            busWrite<Core>(BC, AF >> 8);
             cyclesDelta = 2;
             break;
         case 0x12:
-            Memory::writeByte(DE, AF >> 8);
+            busWrite<Core>(DE, AF >> 8);
             cyclesDelta = 2;
             break;
         case 0x77:
-            Memory::writeByte(HL, AF >> 8);
+            busWrite<Core>(HL, AF >> 8);
             cyclesDelta = 2;
             break;
         case 0xEA:
-            Memory::writeByte(readNn(), AF >> 8);
+            busWrite<Core>(readNn<Core>(), AF >> 8);
             cyclesDelta = 4;
             break;
 
         // LD A,(C)
         case 0xF2:
-            AF = LD_Nn_n(AF, Memory::readByte(BC | 0xFF00));
+            AF = LD_Nn_n(AF, busRead<Core>(BC | 0xFF00));
             cyclesDelta = 2;
             break;
 
         // LD (C),A
         case 0xE2:
-            Memory::writeByte(BC | 0xFF00, AF >> 8);
+            busWrite<Core>(BC | 0xFF00, AF >> 8);
             cyclesDelta = 2;
             break;
 
         // LDH (n),A
         case 0xE0:
-            Memory::writeByte(0xFF00 + readOp(), AF >> 8);
+            busWrite<Core>(0xFF00 + readOp<Core>(), AF >> 8);
             cyclesDelta = 3;
             break;
 
         // LDH A,(n)
         case 0xF0:
-            AF = LD_Nn_n(AF, Memory::readByte(0xFF00 + readOp()));
+            AF = LD_Nn_n(AF, busRead<Core>(0xFF00 + readOp<Core>()));
             cyclesDelta = 3;
             break;
 
         // LDD A,(HL)
         case 0x3A:
-            AF = LD_Nn_n(AF, Memory::readByte(HL));
+            AF = LD_Nn_n(AF, busRead<Core>(HL));
             HL--;
             cyclesDelta = 2;
             break;
 
         // LDD (HL),A
         case 0x32:
-            Memory::writeByte(HL, AF >> 8);
+            busWrite<Core>(HL, AF >> 8);
             HL--;
             cyclesDelta = 2;
             break;
 
         // LDI (HL),A
         case 0x22:
-            Memory::writeByte(HL, AF >> 8);
+            busWrite<Core>(HL, AF >> 8);
             HL++;
             cyclesDelta = 2;
             break;
 
         // LDI A,(HL)
         case 0x2A:
-            AF = LD_Nn_n(AF, Memory::readByte(HL));
+            AF = LD_Nn_n(AF, busRead<Core>(HL));
             HL++;
             cyclesDelta = 2;
             break;
 
         // LD n,nn
         case 0x01:
-            BC = readNn();
+            BC = readNn<Core>();
             cyclesDelta = 3;
             break;
         case 0x11:
-            DE = readNn();
+            DE = readNn<Core>();
             cyclesDelta = 3;
             break;
         case 0x21:
-            HL = readNn();
+            HL = readNn<Core>();
             cyclesDelta = 3;
             break;
         case 0x31:
-            SP = readNn();
+            SP = readNn<Core>();
             cyclesDelta = 3;
             break;
 
@@ -759,7 +822,7 @@ void CPU::cpuStep() {
 
         // LDHL SP,n
         case 0xF8:
-            sn = (int8_t)readOp();
+            sn = (int8_t)readOp<Core>();
             HL = SP + sn;
             AF = LD_nN_n(AF, HALF_S(SP, sn) | CARRY_S(HL & 0xFF, SP & 0xFF, sn));
             cyclesDelta = 3;
@@ -767,45 +830,45 @@ void CPU::cpuStep() {
 
         // LD (nn),SP
         case 0x08:
-            nn = readNn();
-            Memory::writeByte(nn, SP & 0xFF);
-            Memory::writeByte(nn + 1, SP >> 8);
+            nn = readNn<Core>();
+            busWrite<Core>(nn, SP & 0xFF);
+            busWrite<Core>(nn + 1, SP >> 8);
             cyclesDelta = 5;
             break;
 
         // PUSH nn
         case 0xF5:
-            pushStack(AF);
+            pushStack<Core>(AF);
             cyclesDelta = 4;
             break;
         case 0xC5:
-            pushStack(BC);
+            pushStack<Core>(BC);
             cyclesDelta = 4;
             break;
         case 0xD5:
-            pushStack(DE);
+            pushStack<Core>(DE);
             cyclesDelta = 4;
             break;
         case 0xE5:
-            pushStack(HL);
+            pushStack<Core>(HL);
             cyclesDelta = 4;
             break;
 
         // POP nn
         case 0xF1:
-            AF = popStack() & 0xFFF0;
+            AF = popStack<Core>() & 0xFFF0;
             cyclesDelta = 3;
             break;
         case 0xC1:
-            BC = popStack();
+            BC = popStack<Core>();
             cyclesDelta = 3;
             break;
         case 0xD1:
-            DE = popStack();
+            DE = popStack<Core>();
             cyclesDelta = 3;
             break;
         case 0xE1:
-            HL = popStack();
+            HL = popStack<Core>();
             cyclesDelta = 3;
             break;
 
@@ -868,7 +931,7 @@ void CPU::cpuStep() {
             break;
         case 0x86:
             n1 = AF >> 8;
-            n2 = Memory::readByte(HL);
+            n2 = busRead<Core>(HL);
             AF = LD_Nn_n(AF, n1 + n2);
             n = AF >> 8;
             AF = LD_nN_n(AF, ZERO_S(AF & 0xFF00) | HALF_S(n1, n2) | CARRY_S(n, n1, n2));
@@ -876,7 +939,7 @@ void CPU::cpuStep() {
             break;
         case 0xC6:
             n1 = AF >> 8;
-            n2 = readOp();
+            n2 = readOp<Core>();
             AF = LD_Nn_n(AF, n1 + n2);
             n = AF >> 8;
             AF = LD_nN_n(AF, ZERO_S(AF & 0xFF00) | HALF_S(n1, n2) | CARRY_S(n, n1, n2));
@@ -949,7 +1012,7 @@ void CPU::cpuStep() {
             break;
         case 0x8E:
             n1 = AF >> 8;
-            n2 = Memory::readByte(HL);
+            n2 = busRead<Core>(HL);
             c = CARRY_F(AF) >> 4;
             AF = LD_Nn_n(AF, n1 + n2 + c);
             n = AF >> 8;
@@ -958,7 +1021,7 @@ void CPU::cpuStep() {
             break;
         case 0xCE:
             n1 = AF >> 8;
-            n2 = readOp();
+            n2 = readOp<Core>();
             c = CARRY_F(AF) >> 4;
             AF = LD_Nn_n(AF, n1 + n2 + c);
             n = AF >> 8;
@@ -1018,14 +1081,14 @@ void CPU::cpuStep() {
             break;
         case 0x96:
             n1 = AF >> 8;
-            n2 = Memory::readByte(HL);
+            n2 = busRead<Core>(HL);
             AF = LD_Nn_n(AF, n1 - n2);
             AF = LD_nN_n(AF, ZERO_S(AF & 0xFF00) | SUB_V | HBORROW_S(n1, n2) | BORROW_S(n1, n2));
             cyclesDelta = 2;
             break;
         case 0xD6:
             n1 = AF >> 8;
-            n2 = readOp();
+            n2 = readOp<Core>();
             AF = LD_Nn_n(AF, n1 - n2);
             AF = LD_nN_n(AF, ZERO_S(AF & 0xFF00) | SUB_V | HBORROW_S(n1, n2) | BORROW_S(n1, n2));
             cyclesDelta = 2;
@@ -1090,7 +1153,7 @@ void CPU::cpuStep() {
             break;
         case 0x9E:
             n1 = AF >> 8;
-            n2 = Memory::readByte(HL);
+            n2 = busRead<Core>(HL);
             c = CARRY_F(AF) >> 4;
             AF = LD_Nn_n(AF, n1 - n2 - c);
             AF = LD_nN_n(AF, ZERO_S(AF & 0xFF00) | SUB_V | HBORROW_Sc(n1, n2, c) | BORROW_Sc(n1, n2, c));
@@ -1098,7 +1161,7 @@ void CPU::cpuStep() {
             break;
         case 0xDE:
             n1 = AF >> 8;
-            n2 = readOp();
+            n2 = readOp<Core>();
             c = CARRY_F(AF) >> 4;
             AF = LD_Nn_n(AF, n1 - n2 - c);
             AF = LD_nN_n(AF, ZERO_S(AF & 0xFF00) | SUB_V | HBORROW_Sc(n1, n2, c) | BORROW_Sc(n1, n2, c));
@@ -1144,12 +1207,12 @@ void CPU::cpuStep() {
             cyclesDelta = 1;
             break;
         case 0xA6:
-            AF = LD_Nn_n(AF, AND_Nn_nN(AF, Memory::readByte(HL)));
+            AF = LD_Nn_n(AF, AND_Nn_nN(AF, busRead<Core>(HL)));
             AF = LD_nN_n(AF, ZERO_S(AF & 0xFF00) | HALF_V);
             cyclesDelta = 2;
             break;
         case 0xE6:
-            AF = LD_Nn_n(AF, AND_Nn_nN(AF, readOp()));
+            AF = LD_Nn_n(AF, AND_Nn_nN(AF, readOp<Core>()));
             AF = LD_nN_n(AF, ZERO_S(AF & 0xFF00) | HALF_V);
             cyclesDelta = 2;
             break;
@@ -1191,12 +1254,12 @@ void CPU::cpuStep() {
             cyclesDelta = 1;
             break;
         case 0xB6:
-            AF = LD_Nn_n(AF, OR_Nn_nN(AF, Memory::readByte(HL)));
+            AF = LD_Nn_n(AF, OR_Nn_nN(AF, busRead<Core>(HL)));
             AF = LD_nN_n(AF, ZERO_S(AF & 0xFF00));
             cyclesDelta = 2;
             break;
         case 0xF6:
-            AF = LD_Nn_n(AF, OR_Nn_nN(AF, readOp()));
+            AF = LD_Nn_n(AF, OR_Nn_nN(AF, readOp<Core>()));
             AF = LD_nN_n(AF, ZERO_S(AF & 0xFF00));
             cyclesDelta = 2;
             break;
@@ -1238,12 +1301,12 @@ void CPU::cpuStep() {
             cyclesDelta = 1;
             break;
         case 0xAE:
-            AF = LD_Nn_n(AF, XOR_Nn_nN(AF, Memory::readByte(HL)));
+            AF = LD_Nn_n(AF, XOR_Nn_nN(AF, busRead<Core>(HL)));
             AF = LD_nN_n(AF, ZERO_S(AF & 0xFF00));
             cyclesDelta = 2;
             break;
         case 0xEE:
-            AF = LD_Nn_n(AF, XOR_Nn_nN(AF, readOp()));
+            AF = LD_Nn_n(AF, XOR_Nn_nN(AF, readOp<Core>()));
             AF = LD_nN_n(AF, ZERO_S(AF & 0xFF00));
             cyclesDelta = 2;
             break;
@@ -1300,14 +1363,14 @@ void CPU::cpuStep() {
             break;
         case 0xBE:
             n1 = AF >> 8;
-            n2 = Memory::readByte(HL);
+            n2 = busRead<Core>(HL);
             n = n1 - n2;
             AF = LD_nN_n(AF, ZERO_S(n) | SUB_V | HBORROW_S(n1, n2) | BORROW_S(n1, n2));
             cyclesDelta = 2;
             break;
         case 0xFE:
             n1 = AF >> 8;
-            n2 = readOp();
+            n2 = readOp<Core>();
             n = n1 - n2;
             AF = LD_nN_n(AF, ZERO_S(n) | SUB_V | HBORROW_S(n1, n2) | BORROW_S(n1, n2));
             cyclesDelta = 2;
@@ -1350,8 +1413,9 @@ void CPU::cpuStep() {
             cyclesDelta = 1;
             break;
         case 0x34:
-            Memory::writeByte(HL, Memory::readByte(HL) + 1);
-            AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL)) | (((Memory::readByte(HL) & 0x0F) == 0) << 5) | CARRY_F(AF));
+            n = busRead<Core>(HL) + 1;
+            busWrite<Core>(HL, n);
+            AF = LD_nN_n(AF, ZERO_S(n) | (((n & 0x0F) == 0) << 5) | CARRY_F(AF));
             cyclesDelta = 3;
             break;
 
@@ -1392,8 +1456,9 @@ void CPU::cpuStep() {
             cyclesDelta = 1;
             break;
         case 0x35:
-            Memory::writeByte(HL, Memory::readByte(HL) - 1);
-            AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL)) | SUB_V | (((Memory::readByte(HL) & 0x0F) == 0x0F) << 5) | CARRY_F(AF));
+            n = busRead<Core>(HL) - 1;
+            busWrite<Core>(HL, n);
+            AF = LD_nN_n(AF, ZERO_S(n) | SUB_V | (((n & 0x0F) == 0x0F) << 5) | CARRY_F(AF));
             cyclesDelta = 3;
             break;
 
@@ -1430,7 +1495,7 @@ void CPU::cpuStep() {
         // ADD SP,n
         case 0xE8:
             nn = SP;
-            sn = (int8_t)readOp();
+            sn = (int8_t)readOp<Core>();
             SP = nn + sn;
             AF = LD_nN_n(AF, HALF_S(nn, sn) | CARRY_S(SP & 0xFF, nn & 0xFF, sn));
             cyclesDelta = 4;
@@ -1506,9 +1571,10 @@ void CPU::cpuStep() {
 
         // Multiple OP codes depending on n
         case 0xCB:
-            // Fetching the next byte takes another cycle
-            n = readOp();
-            cyclesDelta = 1;
+            // The cycle counts of the prefixed instructions include fetching
+            // both bytes
+            n = readOp<Core>();
+            cyclesDelta = 0;
             switch (n) {
                 // RLC c
                 case 0x07:
@@ -1554,9 +1620,11 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x06:
-                    c = (Memory::readByte(HL) >> 7) & 0x01;
-                    Memory::writeByte(HL, (Memory::readByte(HL) << 1) | c);
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL)) | (c << 4));
+                    n = busRead<Core>(HL);
+                    c = (n >> 7) & 0x01;
+                    n = (n << 1) | c;
+                    busWrite<Core>(HL, n);
+                    AF = LD_nN_n(AF, ZERO_S(n) | (c << 4));
                     cyclesDelta += 4;
                     break;
 
@@ -1604,9 +1672,11 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x16:
-                    c = (Memory::readByte(HL) >> 7) & 0x01;
-                    Memory::writeByte(HL, (Memory::readByte(HL) << 1) | (CARRY_F(AF) >> 4));
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL)) | (c << 4));
+                    n = busRead<Core>(HL);
+                    c = (n >> 7) & 0x01;
+                    n = (n << 1) | (CARRY_F(AF) >> 4);
+                    busWrite<Core>(HL, n);
+                    AF = LD_nN_n(AF, ZERO_S(n) | (c << 4));
                     cyclesDelta += 4;
                     break;
 
@@ -1654,9 +1724,11 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x0E:
-                    c = Memory::readByte(HL) & 0x01;
-                    Memory::writeByte(HL, (Memory::readByte(HL) >> 1) | (c << 7));
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL)) | (c << 4));
+                    n = busRead<Core>(HL);
+                    c = n & 0x01;
+                    n = (n >> 1) | (c << 7);
+                    busWrite<Core>(HL, n);
+                    AF = LD_nN_n(AF, ZERO_S(n) | (c << 4));
                     cyclesDelta += 4;
                     break;
 
@@ -1704,9 +1776,11 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x1E:
-                    c = Memory::readByte(HL) & 0x01;
-                    Memory::writeByte(HL, (Memory::readByte(HL) >> 1) | (CARRY_F(AF) << 3));
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL)) | (c << 4));
+                    n = busRead<Core>(HL);
+                    c = n & 0x01;
+                    n = (n >> 1) | (CARRY_F(AF) << 3);
+                    busWrite<Core>(HL, n);
+                    AF = LD_nN_n(AF, ZERO_S(n) | (c << 4));
                     cyclesDelta += 4;
                     break;
 
@@ -1754,9 +1828,11 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x26:
-                    c = (Memory::readByte(HL) >> 7) & 0x01;
-                    Memory::writeByte(HL, Memory::readByte(HL) << 1);
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL)) | (c << 4));
+                    n = busRead<Core>(HL);
+                    c = (n >> 7) & 0x01;
+                    n = n << 1;
+                    busWrite<Core>(HL, n);
+                    AF = LD_nN_n(AF, ZERO_S(n) | (c << 4));
                     cyclesDelta += 4;
                     break;
 
@@ -1804,9 +1880,11 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x2E:
-                    c = Memory::readByte(HL) & 0x01;
-                    Memory::writeByte(HL, (Memory::readByte(HL) >> 1) | (Memory::readByte(HL) & 0x0080));
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL)) | (c << 4));
+                    n = busRead<Core>(HL);
+                    c = n & 0x01;
+                    n = (n >> 1) | (n & 0x0080);
+                    busWrite<Core>(HL, n);
+                    AF = LD_nN_n(AF, ZERO_S(n) | (c << 4));
                     cyclesDelta += 4;
                     break;
 
@@ -1854,9 +1932,11 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x3E:
-                    c = Memory::readByte(HL) & 0x01;
-                    Memory::writeByte(HL, Memory::readByte(HL) >> 1);
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL)) | (c << 4));
+                    n = busRead<Core>(HL);
+                    c = n & 0x01;
+                    n = n >> 1;
+                    busWrite<Core>(HL, n);
+                    AF = LD_nN_n(AF, ZERO_S(n) | (c << 4));
                     cyclesDelta += 4;
                     break;
 
@@ -1890,8 +1970,8 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x46:
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL) & 0x01) | HALF_V | CARRY_F(AF));
-                    cyclesDelta += 4;
+                    AF = LD_nN_n(AF, ZERO_S(busRead<Core>(HL) & 0x01) | HALF_V | CARRY_F(AF));
+                    cyclesDelta += 3;
                     break;
                 case 0x4F:
                     AF = LD_nN_n(AF, ZERO_S(AF & 0x0200) | HALF_V | CARRY_F(AF));
@@ -1922,8 +2002,8 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x4E:
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL) & 0x02) | HALF_V | CARRY_F(AF));
-                    cyclesDelta += 4;
+                    AF = LD_nN_n(AF, ZERO_S(busRead<Core>(HL) & 0x02) | HALF_V | CARRY_F(AF));
+                    cyclesDelta += 3;
                     break;
                 case 0x57:
                     AF = LD_nN_n(AF, ZERO_S(AF & 0x0400) | HALF_V | CARRY_F(AF));
@@ -1954,8 +2034,8 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x56:
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL) & 0x04) | HALF_V | CARRY_F(AF));
-                    cyclesDelta += 4;
+                    AF = LD_nN_n(AF, ZERO_S(busRead<Core>(HL) & 0x04) | HALF_V | CARRY_F(AF));
+                    cyclesDelta += 3;
                     break;
                 case 0x5F:
                     AF = LD_nN_n(AF, ZERO_S(AF & 0x0800) | HALF_V | CARRY_F(AF));
@@ -1986,8 +2066,8 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x5E:
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL) & 0x08) | HALF_V | CARRY_F(AF));
-                    cyclesDelta += 4;
+                    AF = LD_nN_n(AF, ZERO_S(busRead<Core>(HL) & 0x08) | HALF_V | CARRY_F(AF));
+                    cyclesDelta += 3;
                     break;
                 case 0x67:
                     AF = LD_nN_n(AF, ZERO_S(AF & 0x1000) | HALF_V | CARRY_F(AF));
@@ -2018,8 +2098,8 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x66:
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL) & 0x10) | HALF_V | CARRY_F(AF));
-                    cyclesDelta += 4;
+                    AF = LD_nN_n(AF, ZERO_S(busRead<Core>(HL) & 0x10) | HALF_V | CARRY_F(AF));
+                    cyclesDelta += 3;
                     break;
                 case 0x6F:
                     AF = LD_nN_n(AF, ZERO_S(AF & 0x2000) | HALF_V | CARRY_F(AF));
@@ -2050,8 +2130,8 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x6E:
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL) & 0x20) | HALF_V | CARRY_F(AF));
-                    cyclesDelta += 4;
+                    AF = LD_nN_n(AF, ZERO_S(busRead<Core>(HL) & 0x20) | HALF_V | CARRY_F(AF));
+                    cyclesDelta += 3;
                     break;
                 case 0x77:
                     AF = LD_nN_n(AF, ZERO_S(AF & 0x4000) | HALF_V | CARRY_F(AF));
@@ -2082,8 +2162,8 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x76:
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL) & 0x40) | HALF_V | CARRY_F(AF));
-                    cyclesDelta += 4;
+                    AF = LD_nN_n(AF, ZERO_S(busRead<Core>(HL) & 0x40) | HALF_V | CARRY_F(AF));
+                    cyclesDelta += 3;
                     break;
                 case 0x7F:
                     AF = LD_nN_n(AF, ZERO_S(AF & 0x8000) | HALF_V | CARRY_F(AF));
@@ -2114,8 +2194,8 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x7E:
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL) & 0x80) | HALF_V | CARRY_F(AF));
-                    cyclesDelta += 4;
+                    AF = LD_nN_n(AF, ZERO_S(busRead<Core>(HL) & 0x80) | HALF_V | CARRY_F(AF));
+                    cyclesDelta += 3;
                     break;
 
                 // SET b,r
@@ -2148,7 +2228,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0xC6:
-                    Memory::writeByte(HL, Memory::readByte(HL) | 0x01);
+                    busWrite<Core>(HL, busRead<Core>(HL) | 0x01);
                     cyclesDelta += 4;
                     break;
                 case 0xCF:
@@ -2180,7 +2260,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0xCE:
-                    Memory::writeByte(HL, Memory::readByte(HL) | 0x02);
+                    busWrite<Core>(HL, busRead<Core>(HL) | 0x02);
                     cyclesDelta += 4;
                     break;
                 case 0xD7:
@@ -2212,7 +2292,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0xD6:
-                    Memory::writeByte(HL, Memory::readByte(HL) | 0x04);
+                    busWrite<Core>(HL, busRead<Core>(HL) | 0x04);
                     cyclesDelta += 4;
                     break;
                 case 0xDF:
@@ -2244,7 +2324,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0xDE:
-                    Memory::writeByte(HL, Memory::readByte(HL) | 0x08);
+                    busWrite<Core>(HL, busRead<Core>(HL) | 0x08);
                     cyclesDelta += 4;
                     break;
                 case 0xE7:
@@ -2276,7 +2356,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0xE6:
-                    Memory::writeByte(HL, Memory::readByte(HL) | 0x10);
+                    busWrite<Core>(HL, busRead<Core>(HL) | 0x10);
                     cyclesDelta += 4;
                     break;
                 case 0xEF:
@@ -2308,7 +2388,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0xEE:
-                    Memory::writeByte(HL, Memory::readByte(HL) | 0x20);
+                    busWrite<Core>(HL, busRead<Core>(HL) | 0x20);
                     cyclesDelta += 4;
                     break;
                 case 0xF7:
@@ -2340,7 +2420,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0xF6:
-                    Memory::writeByte(HL, Memory::readByte(HL) | 0x40);
+                    busWrite<Core>(HL, busRead<Core>(HL) | 0x40);
                     cyclesDelta += 4;
                     break;
                 case 0xFF:
@@ -2372,7 +2452,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0xFE:
-                    Memory::writeByte(HL, Memory::readByte(HL) | 0x80);
+                    busWrite<Core>(HL, busRead<Core>(HL) | 0x80);
                     cyclesDelta += 4;
                     break;
 
@@ -2406,7 +2486,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x86:
-                    Memory::writeByte(HL, Memory::readByte(HL) & 0xFE);
+                    busWrite<Core>(HL, busRead<Core>(HL) & 0xFE);
                     cyclesDelta += 4;
                     break;
                 case 0x8F:
@@ -2438,7 +2518,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x8E:
-                    Memory::writeByte(HL, Memory::readByte(HL) & 0xFD);
+                    busWrite<Core>(HL, busRead<Core>(HL) & 0xFD);
                     cyclesDelta += 4;
                     break;
                 case 0x97:
@@ -2470,7 +2550,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x96:
-                    Memory::writeByte(HL, Memory::readByte(HL) & 0xFB);
+                    busWrite<Core>(HL, busRead<Core>(HL) & 0xFB);
                     cyclesDelta += 4;
                     break;
                 case 0x9F:
@@ -2502,7 +2582,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x9E:
-                    Memory::writeByte(HL, Memory::readByte(HL) & 0xF7);
+                    busWrite<Core>(HL, busRead<Core>(HL) & 0xF7);
                     cyclesDelta += 4;
                     break;
                 case 0xA7:
@@ -2534,7 +2614,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0xA6:
-                    Memory::writeByte(HL, Memory::readByte(HL) & 0xEF);
+                    busWrite<Core>(HL, busRead<Core>(HL) & 0xEF);
                     cyclesDelta += 4;
                     break;
                 case 0xAF:
@@ -2566,7 +2646,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0xAE:
-                    Memory::writeByte(HL, Memory::readByte(HL) & 0xDF);
+                    busWrite<Core>(HL, busRead<Core>(HL) & 0xDF);
                     cyclesDelta += 4;
                     break;
                 case 0xB7:
@@ -2598,7 +2678,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0xB6:
-                    Memory::writeByte(HL, Memory::readByte(HL) & 0xBF);
+                    busWrite<Core>(HL, busRead<Core>(HL) & 0xBF);
                     cyclesDelta += 4;
                     break;
                 case 0xBF:
@@ -2630,7 +2710,7 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0xBE:
-                    Memory::writeByte(HL, Memory::readByte(HL) & 0x7F);
+                    busWrite<Core>(HL, busRead<Core>(HL) & 0x7F);
                     cyclesDelta += 4;
                     break;
 
@@ -2671,8 +2751,10 @@ void CPU::cpuStep() {
                     cyclesDelta += 2;
                     break;
                 case 0x36:
-                    Memory::writeByte(HL, ((Memory::readByte(HL) & 0xF0) >> 4) | ((Memory::readByte(HL) & 0x0F) << 4));
-                    AF = LD_nN_n(AF, ZERO_S(Memory::readByte(HL)));
+                    n = busRead<Core>(HL);
+                    n = ((n & 0xF0) >> 4) | ((n & 0x0F) << 4);
+                    busWrite<Core>(HL, n);
+                    AF = LD_nN_n(AF, ZERO_S(n));
                     cyclesDelta += 4;
                     break;
 
@@ -2730,13 +2812,13 @@ void CPU::cpuStep() {
 
         // JP nn
         case 0xC3:
-            PC = readNn();
+            PC = readNn<Core>();
             cyclesDelta = 4;
             break;
 
         // JP cc,nn
         case 0xC2:
-            nn = readNn();
+            nn = readNn<Core>();
             if (ZERO_F(AF) == 0) {
                 PC = nn;
                 cyclesDelta = 4;
@@ -2745,7 +2827,7 @@ void CPU::cpuStep() {
             }
             break;
         case 0xCA:
-            nn = readNn();
+            nn = readNn<Core>();
             if (ZERO_F(AF) == ZERO_V) {
                 PC = nn;
                 cyclesDelta = 4;
@@ -2754,7 +2836,7 @@ void CPU::cpuStep() {
             }
             break;
         case 0xD2:
-            nn = readNn();
+            nn = readNn<Core>();
             if (CARRY_F(AF) == 0) {
                 PC = nn;
                 cyclesDelta = 4;
@@ -2763,7 +2845,7 @@ void CPU::cpuStep() {
             }
             break;
         case 0xDA:
-            nn = readNn();
+            nn = readNn<Core>();
             if (CARRY_F(AF) == CARRY_V) {
                 PC = nn;
                 cyclesDelta = 4;
@@ -2780,13 +2862,13 @@ void CPU::cpuStep() {
 
         // JR n
         case 0x18:
-            PC += (int8_t)readOp();
+            PC += (int8_t)readOp<Core>();
             cyclesDelta = 3;
             break;
 
         // JR cc,n
         case 0x20:
-            n = readOp();
+            n = readOp<Core>();
             if (ZERO_F(AF) == 0) {
                 PC += (int8_t)n;
                 cyclesDelta = 3;
@@ -2795,7 +2877,7 @@ void CPU::cpuStep() {
             }
             break;
         case 0x28:
-            n = readOp();
+            n = readOp<Core>();
             if (ZERO_F(AF) == ZERO_V) {
                 PC += (int8_t)n;
                 cyclesDelta = 3;
@@ -2804,7 +2886,7 @@ void CPU::cpuStep() {
             }
             break;
         case 0x30:
-            n = readOp();
+            n = readOp<Core>();
             if (CARRY_F(AF) == 0) {
                 PC += (int8_t)n;
                 cyclesDelta = 3;
@@ -2813,7 +2895,7 @@ void CPU::cpuStep() {
             }
             break;
         case 0x38:
-            n = readOp();
+            n = readOp<Core>();
             if (CARRY_F(AF) == CARRY_V) {
                 PC += (int8_t)n;
                 cyclesDelta = 3;
@@ -2824,17 +2906,17 @@ void CPU::cpuStep() {
 
         // CALL nn
         case 0xCD:
-            nn = readNn();
-            pushStack(PC);
+            nn = readNn<Core>();
+            pushStack<Core>(PC);
             PC = nn;
             cyclesDelta = 6;
             break;
 
         // CALL cc,nn
         case 0xC4:
-            nn = readNn();
+            nn = readNn<Core>();
             if (ZERO_F(AF) == 0) {
-                pushStack(PC);
+                pushStack<Core>(PC);
                 PC = nn;
                 cyclesDelta = 6;
             } else {
@@ -2842,9 +2924,9 @@ void CPU::cpuStep() {
             }
             break;
         case 0xCC:
-            nn = readNn();
+            nn = readNn<Core>();
             if (ZERO_F(AF) == ZERO_V) {
-                pushStack(PC);
+                pushStack<Core>(PC);
                 PC = nn;
                 cyclesDelta = 6;
             } else {
@@ -2852,9 +2934,9 @@ void CPU::cpuStep() {
             }
             break;
         case 0xD4:
-            nn = readNn();
+            nn = readNn<Core>();
             if (CARRY_F(AF) == 0) {
-                pushStack(PC);
+                pushStack<Core>(PC);
                 PC = nn;
                 cyclesDelta = 6;
             } else {
@@ -2862,9 +2944,9 @@ void CPU::cpuStep() {
             }
             break;
         case 0xDC:
-            nn = readNn();
+            nn = readNn<Core>();
             if (CARRY_F(AF) == CARRY_V) {
-                pushStack(PC);
+                pushStack<Core>(PC);
                 PC = nn;
                 cyclesDelta = 6;
             } else {
@@ -2874,56 +2956,56 @@ void CPU::cpuStep() {
 
         // RST n
         case 0xC7:
-            pushStack(PC);
+            pushStack<Core>(PC);
             PC = 0x00;
             cyclesDelta = 4;
             break;
         case 0xCF:
-            pushStack(PC);
+            pushStack<Core>(PC);
             PC = 0x08;
             cyclesDelta = 4;
             break;
         case 0xD7:
-            pushStack(PC);
+            pushStack<Core>(PC);
             PC = 0x10;
             cyclesDelta = 4;
             break;
         case 0xDF:
-            pushStack(PC);
+            pushStack<Core>(PC);
             PC = 0x18;
             cyclesDelta = 4;
             break;
         case 0xE7:
-            pushStack(PC);
+            pushStack<Core>(PC);
             PC = 0x20;
             cyclesDelta = 4;
             break;
         case 0xEF:
-            pushStack(PC);
+            pushStack<Core>(PC);
             PC = 0x28;
             cyclesDelta = 4;
             break;
         case 0xF7:
-            pushStack(PC);
+            pushStack<Core>(PC);
             PC = 0x30;
             cyclesDelta = 4;
             break;
         case 0xFF:
-            pushStack(PC);
+            pushStack<Core>(PC);
             PC = 0x38;
             cyclesDelta = 4;
             break;
 
         // RET
         case 0xC9:
-            PC = popStack();
+            PC = popStack<Core>();
             cyclesDelta = 4;
             break;
 
         // RET cc
         case 0xC0:
             if (ZERO_F(AF) == 0) {
-                PC = popStack();
+                PC = popStack<Core>();
                 cyclesDelta = 5;
             } else {
                 cyclesDelta = 2;
@@ -2931,7 +3013,7 @@ void CPU::cpuStep() {
             break;
         case 0xC8:
             if (ZERO_F(AF) == ZERO_V) {
-                PC = popStack();
+                PC = popStack<Core>();
                 cyclesDelta = 5;
             } else {
                 cyclesDelta = 2;
@@ -2939,7 +3021,7 @@ void CPU::cpuStep() {
             break;
         case 0xD0:
             if (CARRY_F(AF) == 0) {
-                PC = popStack();
+                PC = popStack<Core>();
                 cyclesDelta = 5;
             } else {
                 cyclesDelta = 2;
@@ -2947,7 +3029,7 @@ void CPU::cpuStep() {
             break;
         case 0xD8:
             if (CARRY_F(AF) == CARRY_V) {
-                PC = popStack();
+                PC = popStack<Core>();
                 cyclesDelta = 5;
             } else {
                 cyclesDelta = 2;
@@ -2956,7 +3038,7 @@ void CPU::cpuStep() {
 
         // RETI
         case 0xD9:
-            PC = popStack();
+            PC = popStack<Core>();
             enableIRQ = 2;
             cyclesDelta = 4;
             break;
@@ -2967,6 +3049,15 @@ void CPU::cpuStep() {
             break;
     }
 
+    // Run the remaining internal cycles of the instruction
+    // Interrupt dispatch adds the cycles of pushing PC
+    if (Core::timedMemory) {
+        while (stepCycles < cyclesDelta) {
+            tick<Core>();
+        }
+        cyclesDelta = stepCycles;
+    }
+
     totalCycles += cyclesDelta;
 
     if (enableIRQ != 0 && --enableIRQ == 0) {
@@ -2976,4 +3067,7 @@ void CPU::cpuStep() {
     if (disableIRQ != 0 && --disableIRQ == 0) {
         IME = 0;
     }
-}
\ No newline at end of file
+}
+
+template void CPU::cpuStep<FastCore>();
+template void CPU::cpuStep<AccurateCore>();
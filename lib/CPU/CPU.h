@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <Accuracy.h>
 #include <Arduino.h>
 
 class CPU {
@@ -25,13 +26,27 @@ class CPU {
     static volatile bool cpuEnabled;
     static volatile uint64_t totalCycles;
 
+    template <typename Core>
     static void cpuStep();
     static void stopAndRestart();
 
+    // Debug
+    static void dumpRegister();
+
    protected:
+    template <typename Core>
+    static void tick();
+    template <typename Core>
+    static uint8_t busRead(const uint16_t location);
+    template <typename Core>
+    static void busWrite(const uint16_t location, const uint8_t data);
+    template <typename Core>
     static uint8_t readOp();
+    template <typename Core>
     static uint16_t readNn();
+    template <typename Core>
     static void pushStack(const uint16_t data);
+    template <typename Core>
     static uint16_t popStack();
 
    private:
@@ -66,7 +81,9 @@ class CPU {
 
     static uint8_t cyclesDelta;
 
+    // Machine cycles already run by the current step, timed memory only
+    static uint8_t stepCycles;
+
     // Debug
-    static void dumpRegister();
     static void dumpStack();
 };
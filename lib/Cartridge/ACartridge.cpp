@@ -22,76 +22,49 @@
 #include <SPI.h>
 #include <stdlib.h>
 
-ACartridge::ACartridge(const char* romFile) {
-    Serial.println("Initializing SD card...");
-    // See if the card is present and can be initialized
-    if (!SD.begin(BUILTIN_SDCARD)) {
-        Serial.println("SD Card failed, or not present");
-        return;
-    }
-    Serial.println("SD Card Initialized!");
-
-    dataFile = SD.open(romFile);
-    if (dataFile) {
-        // Get the cartridge code
-        dataFile.seek(CART_CODE);
-        cartCode = dataFile.read();
-        cartType = lookupCartType(cartCode);
-        // Get the amount of ROM in the cart
-        romCode = dataFile.read();
-        romBankCount = lookupRomBanks(romCode);
-        romSize = lookupRomSize(romSize);
-        // Get the amount of RAM in the car
-
-        ramCode = dataFile.read();
-        ramBankCount = lookupRamBanks(ramCode);
-        ramBankSize = lookupRamBankSize(ramCode);
-        ramSize = lookupRamSize(ramCode);
-        // Get the name of the cart
-        dataFile.seek(CART_NAME);
-        for (uint8_t i = 0; i < 16; i++) {
-            name[i] = dataFile.read();
-        }
-        Serial.println("Cartridge Info:");
-        Serial.println("----------");
-        Serial.printf("Game Name: %s\n", name);
-        Serial.printf("\tCart Code: 0x%x\n", cartCode);
-        Serial.printf("\tCart Type: %s\n", cartType);
-        Serial.printf("\tMemory Bank Controller: %s\n", lookupMBCTypeString(cartCode));
-        Serial.println("ROM Info:");
-        Serial.printf("\tROM Code: 0x%x\n", romCode);
-        Serial.printf("\tROM Banks: %i\n", romBankCount);
-        Serial.printf("\tROM Size: 0x%x\n", romSize);
-        Serial.println("RAM Info:");
-        Serial.printf("\tRAM Code: 0x%x\n", ramCode);
-        Serial.printf("\tRAM Banks: %i\n", ramBankCount);
-        Serial.printf("\tRAM Size: 0x%x\n", ramSize);
-        Serial.printf("\tRAM Bank Size: 0x%x\n", ramBankSize);
-    } else {
-        Serial.println("Unable to read cartridge");
+// The file stays open for the MBC to load the ROM from
+ACartridge::ACartridge(File romFile, const uint8_t* header)
+    : arena(0), valid(true), ram(0), save(0), romImage(0), romCache(0), container(0), dataFile(romFile) {
+    readHeader(header);
+
+    // Compressed ROM files are decompressed bank by bank while loading
+    uint8_t magic[ROM_CONTAINER_MAGIC_SIZE];
+    if (dataFile.seek(0) && dataFile.read(magic, ROM_CONTAINER_MAGIC_SIZE) == ROM_CONTAINER_MAGIC_SIZE && RomContainer::isContainer(magic)) {
+        container = new RomContainer(dataFile, romBankCount);
     }
 }
 
-ACartridge::ACartridge(const uint8_t* data) {
+ACartridge::ACartridge(const uint8_t* data) : arena(0), valid(true), ram(0), save(0), romImage(0), romCache(0), container(0) { readHeader(data); }
+
+void ACartridge::readHeader(const uint8_t* header) {
     // Get the cartridge code
-    cartCode = data[CART_CODE];
+    cartCode = header[CART_CODE];
     cartType = lookupCartType(cartCode);
 
     // Get the amount of ROM in the cart
-    romCode = data[ROM_CODE];
+    romCode = header[ROM_CODE];
     romBankCount = lookupRomBanks(romCode);
-    romSize = lookupRomSize(romSize);
+    romSize = lookupRomSize(romCode);
 
     // Get the amount of RAM in the car
-    ramCode = data[RAM_CODE];
+    ramCode = header[RAM_CODE];
     ramBankCount = lookupRamBanks(ramCode);
     ramBankSize = lookupRamBankSize(ramCode);
     ramSize = lookupRamSize(ramCode);
 
     // Get the name of the cart
     for (uint8_t i = 0; i < 16; i++) {
-        name[i] = data[CART_NAME + i];
+        name[i] = header[CART_NAME + i];
+    }
+
+    // The header checksum covers the title up to the version number
+    uint8_t headerChecksum = 0;
+    for (uint16_t i = CART_NAME; i < CART_HEADER_CHECKSUM; i++) {
+        headerChecksum = headerChecksum - header[i] - 1;
     }
+    // The global checksum covers the whole ROM and is verified when the ROM
+    // is loaded completely
+    globalChecksum = (header[CART_GLOBAL_CHECKSUM] << 8) | header[CART_GLOBAL_CHECKSUM + 1];
 
     Serial.println("Cartridge Info:");
     Serial.println("----------");
@@ -99,6 +72,7 @@ ACartridge::ACartridge(const uint8_t* data) {
     Serial.printf("\tCart Code: 0x%x\n", cartCode);
     Serial.printf("\tCart Type: %s\n", cartType);
     Serial.printf("\tMemory Bank Controller: %s\n", lookupMBCTypeString(cartCode));
+    Serial.printf("\tHeader Checksum: %s\n", headerChecksum == header[CART_HEADER_CHECKSUM] ? "OK" : "Mismatch");
     Serial.println("ROM Info:");
     Serial.printf("\tROM Code: 0x%x\n", romCode);
     Serial.printf("\tROM Banks: %i\n", romBankCount);
@@ -110,7 +84,169 @@ ACartridge::ACartridge(const uint8_t* data) {
     Serial.printf("\tRAM Bank Size: 0x%x\n", ramBankSize);
 }
 
-ACartridge::~ACartridge() { Serial.println("Deleting Cartridge"); }
+bool ACartridge::loadRom(uint8_t* rom, const uint32_t size) {
+    Serial.println("Loading ROM into memory...");
+    const uint32_t start = micros();
+
+    // Stream the file in chunks of whole SD card sectors and sum up the
+    // bytes for the global checksum while they are still in the cache
+    // Compressed ROMs are loaded in chunks of whole banks
+    uint16_t checksum = 0;
+    uint32_t loaded = 0;
+    dataFile.seek(0);
+    while (loaded < size) {
+        uint16_t chunkSize = (size - loaded) < ROM_LOAD_CHUNK_SIZE ? (size - loaded) : ROM_LOAD_CHUNK_SIZE;
+        uint8_t* chunk = rom + loaded;
+        bool read;
+        if (container) {
+            chunkSize = ROM_BANK_SIZE;
+            read = container->readBank(loaded >> ROM_BANK_SHIFT, chunk);
+        } else {
+            read = dataFile.read(chunk, chunkSize) == chunkSize;
+        }
+        if (!read) {
+            Serial.printf("Could not read ROM at 0x%x\n", loaded);
+            return false;
+        }
+        for (uint16_t i = 0; i < chunkSize; i++) {
+            checksum += chunk[i];
+        }
+        loaded += chunkSize;
+    }
+    // The checksum bytes themselves are not part of the checksum
+    checksum -= rom[CART_GLOBAL_CHECKSUM] + rom[CART_GLOBAL_CHECKSUM + 1];
+
+    const uint32_t time = micros() - start;
+    const uint32_t rate = (uint64_t)size * 100000000 / 1048576 / (time + 1);
+    Serial.printf("ROM Loaded! %lu KB in %lu us (%lu.%02lu MB/s)\n", (unsigned long)(size / 1024), (unsigned long)time, (unsigned long)(rate / 100),
+                  (unsigned long)(rate % 100));
+    // The hardware never checks the global checksum, so a mismatch is only
+    // reported
+    Serial.printf("\tGlobal Checksum: %s\n", checksum == globalChecksum ? "OK" : "Mismatch");
+    return true;
+}
+
+ACartridge::~ACartridge() {
+    Serial.println("Deleting Cartridge");
+    // Write back the save RAM before the arena is released
+    delete save;
+    delete romCache;
+    delete container;
+    dataFile.close();
+#if defined(ARDUINO_TEENSY41)
+    extmem_free(arena);
+#else
+    free(arena);
+#endif
+}
+
+uint8_t* ACartridge::allocateArena(const uint32_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    // Put the cartridge into the external PSRAM if the Teensy 4.1 has some,
+    // extmem_malloc falls back to internal RAM otherwise
+#if defined(ARDUINO_TEENSY41)
+    arena = (uint8_t*)extmem_malloc(size);
+#else
+    arena = (uint8_t*)malloc(size);
+#endif
+    if (arena == 0) {
+        Serial.printf("Could not allocate %lu KB for the cartridge\n", (unsigned long)(size / 1024));
+        valid = false;
+        return 0;
+    }
+    return arena;
+}
+
+const uint8_t* ACartridge::getReadPointer(uint16_t addr) { return 0; }
+
+uint8_t* ACartridge::initRomBanks(const uint8_t romBankFrames, const uint32_t ramSize) {
+    // Page the ROM banks in from the SD card when they are selected
+    // instead of loading the whole ROM, which might not fit in RAM
+    // The frames and the cartridge RAM share the arena
+    const uint8_t frameCount = RomBankCache::getFrameCount(romBankCount, romBankFrames);
+    if (allocateArena(frameCount * ROM_BANK_SIZE + ramSize) == 0) {
+        return 0;
+    }
+    romCache = new RomBankCache(dataFile, container, romBankCount, frameCount, arena);
+    uint8_t* ram = arena + frameCount * ROM_BANK_SIZE;
+    memset(ram, 0, ramSize);
+
+    // Load ROMs that fit into the frames at once
+    uint8_t* rom = romCache->mapAllBanks();
+    if (rom) {
+        valid = loadRom(rom, romBankCount * ROM_BANK_SIZE);
+    }
+    return ram;
+}
+
+uint8_t* ACartridge::initRomBanks(const uint8_t* data, const uint32_t ramSize) {
+    // The ROM banks are read straight from the image, which has to stay
+    // around as long as the cartridge. Only cartridge RAM is allocated
+    Serial.println("Running ROM from memory");
+    romImage = data;
+    uint8_t* ram = allocateArena(ramSize);
+    if (ram) {
+        memset(ram, 0, ramSize);
+    }
+    return ram;
+}
+
+const uint8_t* ACartridge::mapRomBank(const uint16_t bank, const uint8_t region) {
+    if (romCache) {
+        return romCache->selectBank(bank, region);
+    }
+    return romImage + (bank << ROM_BANK_SHIFT);
+}
+
+void ACartridge::printStats() {
+    if (romCache) {
+        romCache->printStats();
+    }
+    if (container) {
+        container->printStats();
+    }
+    if (save) {
+        save->printStats();
+    }
+}
+
+void ACartridge::beginSave(const char* romFile) {
+    if (!lookupHasBattery(cartCode) || ram == 0 || ramSize == 0) {
+        return;
+    }
+    // Replace the extension of the ROM file
+    char path[CART_SAVE_PATH_SIZE];
+    strncpy(path, romFile, CART_SAVE_PATH_SIZE - 5);
+    path[CART_SAVE_PATH_SIZE - 5] = 0;
+    char* extension = strrchr(path, '.');
+    if (extension == 0 || strchr(extension, '/') != 0) {
+        extension = path + strlen(path);
+    }
+    strcpy(extension, ".sav");
+    save = new SaveRam(path, ram, ramSize);
+}
+
+void ACartridge::saveStep() {
+    if (save) {
+        save->step();
+    }
+}
+
+void ACartridge::ramWritten(const uint8_t* location) {
+    if (save) {
+        save->markDirty(location);
+    }
+}
+
+void ACartridge::ramDisabled() {
+    if (save) {
+        save->requestFlush();
+    }
+}
+
+bool ACartridge::isValid() { return valid; }
 
 uint8_t ACartridge::getCartCode() { return cartCode; }
 
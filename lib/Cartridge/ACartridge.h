@@ -20,22 +20,78 @@
 #include <SD.h>
 
 #include "CartHelpers.h"
+#include "RomBankCache.h"
+#include "SaveRam.h"
 
 class ACartridge {
    public:
-    ACartridge(const char* romFile);
+    // Construct from an open ROM file and its header
+    ACartridge(File romFile, const uint8_t* header);
     ACartridge(const uint8_t* data);
     // Abstract readByte. It should be defined in every MBC
     virtual uint8_t readByte(uint16_t addr) = 0;
     // Abstract writeByte. It should be defined in every MBC
     virtual void writeByte(uint16_t addr, uint8_t data) = 0;
+    // Resolve an address to host memory for block transfers. Returns 0
+    // if the address can't be accessed directly. The pointer has to stay
+    // valid up to the end of the 256 byte page of addr
+    virtual const uint8_t* getReadPointer(uint16_t addr);
+    // Print statistics about the cartridge memory, if there are any
+    virtual void printStats();
+    // Keep the RAM of battery backed cartridges in a save file named
+    // after the ROM file, e.g. roms/tetris.sav for roms/tetris.gb
+    void beginSave(const char* romFile);
+    // Write back changed save RAM in the background
+    void saveStep();
     virtual ~ACartridge();
+    // False if the memory of the cartridge couldn't be allocated or the
+    // ROM couldn't be loaded, the cartridge must not be inserted then
+    bool isValid();
     uint8_t getCartCode();
     uint8_t getRomCode();
     uint8_t getRamCode();
     char* getGameName();
 
    protected:
+    // Read the metadata from the cartridge header
+    void readHeader(const uint8_t* header);
+    // Load size bytes of the ROM file into rom and verify the global checksum
+    // Returns false if the file is too short, a checksum mismatch is only
+    // reported
+    bool loadRom(uint8_t* rom, const uint32_t size);
+    // Allocate all ROM and RAM memory of the cartridge as a single block
+    // ROM banks are placed first, so bank n starts at n * ROM_BANK_SIZE
+    // The block is released when the cartridge is deleted
+    uint8_t* allocateArena(const uint32_t size);
+
+    // The memory block of the cartridge, 0 if nothing was allocated
+    uint8_t* arena;
+    // Cleared when setting up the cartridge fails
+    bool valid;
+
+    // Set up banked ROM access for MBCs that switch banks, paged in from
+    // the ROM file into romBankFrames frames or straight from a ROM image
+    // Both allocate ramSize bytes of cleared cartridge RAM and return it
+    uint8_t* initRomBanks(const uint8_t romBankFrames, const uint32_t ramSize);
+    uint8_t* initRomBanks(const uint8_t* data, const uint32_t ramSize);
+    // Get the memory of a ROM bank when it's selected for a ROM region
+    const uint8_t* mapRomBank(const uint16_t bank, const uint8_t region);
+
+    // Cartridge RAM, in the arena. 0 if there is none
+    uint8_t* ram;
+    // Save file of battery backed RAM, 0 if it isn't persisted
+    SaveRam* save;
+    // Called by the MBC on RAM writes and when the game disables the RAM
+    void ramWritten(const uint8_t* location);
+    void ramDisabled();
+
+    // ROM image in memory, e.g. in flash or a mapped file
+    const uint8_t* romImage;
+    // ROM banks paged in from the SD card otherwise
+    RomBankCache* romCache;
+    // Index of compressed ROM files, 0 for plain ROM files
+    RomContainer* container;
+
     // Metadata about the cart
     uint8_t cartCode;
     uint8_t romCode;
@@ -61,4 +117,7 @@ class ACartridge {
 
     // Human readable name for the ROM
     char name[16];
+
+    // The global checksum from the header
+    uint16_t globalChecksum;
 };
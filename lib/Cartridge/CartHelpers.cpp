@@ -138,7 +138,7 @@ uint8_t lookupMbcTypeFromCart(const char* romFile) {
     return ret;
 }
 
-uint8_t lookupMbcTypeFromCart(const uint8_t* data) { return data[CART_CODE]; }
+uint8_t lookupMbcTypeFromCart(const uint8_t* data) { return lookupMbcType(data[CART_CODE]); }
 
 uint16_t lookupRamBankSize(uint8_t code) {
     switch (code) {
@@ -151,36 +151,7 @@ uint16_t lookupRamBankSize(uint8_t code) {
     }
 }
 
-uint32_t lookupRomSize(uint8_t code) {
-    switch (code) {
-        case 0x0:
-            return 0x8000;
-        case 0x1:
-            return 0x20000;
-        case 0x2:
-            return 0x40000;
-        case 0x3:
-            return 0x80000;
-        case 0x4:
-            return 0x100000;
-        case 0x5:
-            return 0x200000;
-        case 0x6:
-            return 0x400000;
-        case 0x7:
-            return 0x800000;
-        case 0x8:
-            return 0x1000000;
-        case 0x52:
-            return 0x240000;
-        case 0x53:
-            return 0x280000;
-        case 0x54:
-            return 0x300000;
-        default:
-            return 0x8000;
-    }
-}
+uint32_t lookupRomSize(uint8_t code) { return lookupRomBanks(code) * ROM_BANK_SIZE; }
 
 uint32_t lookupRamSize(uint8_t code) {
     switch (code) {
@@ -204,7 +175,7 @@ uint32_t lookupRamSize(uint8_t code) {
 uint16_t lookupRomBanks(uint8_t code) {
     switch (code) {
         case 0x0:
-            return 1;
+            return 2;
         case 0x1:
             return 4;
         case 0x2:
@@ -251,6 +222,25 @@ uint8_t lookupRamBanks(uint8_t code) {
     }
 }
 
+bool lookupHasBattery(uint8_t code) {
+    switch (code) {
+        case 0x03:
+        case 0x06:
+        case 0x09:
+        case 0x0D:
+        case 0x0F:
+        case 0x10:
+        case 0x13:
+        case 0x1B:
+        case 0x1E:
+        case 0x22:
+        case 0xFF:
+            return true;
+        default:
+            return false;
+    }
+}
+
 const char* lookupCartType(uint8_t code) {
     switch (code) {
         case 0x00:
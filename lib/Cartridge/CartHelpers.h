@@ -40,6 +40,30 @@
 #define CART_NAME     0x134
 #define ROM_BANK_SIZE 0x4000
 
+// Bank n starts at n << shift in contiguous cartridge memory
+// Only carts with 8KB RAM banks have more than one RAM bank
+#define ROM_BANK_SHIFT 14
+#define RAM_BANK_SHIFT 13
+
+// Cartridge header checksums
+#define CART_HEADER_CHECKSUM 0x14D
+#define CART_GLOBAL_CHECKSUM 0x14E
+#define CART_HEADER_SIZE     0x150
+
+// The largest ROMs have 512 banks (8MB)
+#define ROM_MAX_BANKS 512
+
+// ROM files are read in chunks of whole 512 byte SD card sectors
+#define ROM_LOAD_CHUNK_SIZE 0x1000
+
+// Amount of 16KB frames ROM banks from the SD card are paged into
+#ifndef ROM_BANK_FRAMES
+#define ROM_BANK_FRAMES 16
+#endif
+
+// Longest path of a save file
+#define CART_SAVE_PATH_SIZE 256
+
 // Cartridge Memory Regions
 #define CART_ROM_ZERO   0X0000  // Technically, this can also be banked
 #define CART_ROM_BANKED 0x4000
@@ -53,5 +77,6 @@ uint32_t lookupRomSize(uint8_t code);
 uint32_t lookupRamSize(uint8_t code);
 uint16_t lookupRomBanks(uint8_t code);
 uint8_t lookupRamBanks(uint8_t code);
+bool lookupHasBattery(uint8_t code);
 const char* lookupCartType(uint8_t code);
 const char* lookupMBCTypeString(uint8_t code);
\ No newline at end of file
@@ -18,44 +18,92 @@
 #include "Cartridge.h"
 
 #include <Arduino.h>
+#include <SD.h>
 
 #include "CartHelpers.h"
 #include "MBC1.h"
 #include "MBC2.h"
+#include "MBC3.h"
+#include "MBC5.h"
 #include "NoMBC.h"
 
 ACartridge* Cartridge::cart = 0;
 
-uint8_t Cartridge::begin(const char* romFile) {
-    uint8_t mbcType = lookupMbcTypeFromCart(romFile);
+uint8_t Cartridge::begin(const char* romFile, const uint8_t romBankFrames) {
+    // The file is only opened once, the cartridge keeps it to load the ROM
+    File file = SD.open(romFile);
+    uint8_t header[CART_HEADER_SIZE];
+    if (!file || file.read(header, CART_HEADER_SIZE) != CART_HEADER_SIZE || (RomContainer::isContainer(header) && !RomContainer::readHeader(file, header))) {
+        Serial.printf("Could not open rom file %s\n", romFile);
+        file.close();
+        return 1;
+    }
+
+    // Release the previous cartridge before allocating the new one
+    end();
+
+    uint8_t mbcType = lookupMbcType(header[CART_CODE]);
     if (mbcType == USES_NOMBC) {
-        cart = new NoMBC(romFile);
+        cart = new NoMBC(file, header);
     } else if (mbcType == USES_MBC1) {
-        cart = new MBC1(romFile);
+        cart = new MBC1(file, header, romBankFrames);
     } else if (mbcType == USES_MBC2) {
-        cart = new MBC2(romFile);
+        cart = new MBC2(file, header);
+    } else if (mbcType == USES_MBC3) {
+        cart = new MBC3(file, header, romBankFrames);
+    } else if (mbcType == USES_MBC5) {
+        cart = new MBC5(file, header, romBankFrames);
     } else {
-        Serial.printf("MBC type 0x%x is currently not supported\n");
+        Serial.printf("MBC type 0x%x is currently not supported\n", mbcType);
+        file.close();
+        return 1;
+    }
+    if (!cart->isValid()) {
+        Serial.println("Could not insert the cartridge");
+        end();
         return 1;
     }
+    cart->beginSave(romFile);
     return 0;
 }
 
-uint8_t Cartridge::begin(const uint8_t* data) {
+uint8_t Cartridge::begin(const uint8_t* data, const char* romFile) {
+    end();
+
     uint8_t mbcType = lookupMbcTypeFromCart(data);
     if (mbcType == USES_NOMBC) {
         cart = new NoMBC(data);
     } else if (mbcType == USES_MBC1) {
         cart = new MBC1(data);
+    } else if (mbcType == USES_MBC3) {
+        cart = new MBC3(data);
+    } else if (mbcType == USES_MBC5) {
+        cart = new MBC5(data);
     } else {
-        Serial.printf("MBC type 0x%x is currently not supported\n");
+        Serial.printf("MBC type 0x%x is currently not supported\n", mbcType);
+        return 1;
+    }
+    if (!cart->isValid()) {
+        Serial.println("Could not insert the cartridge");
+        end();
         return 1;
     }
+    if (romFile) {
+        cart->beginSave(romFile);
+    }
     return 0;
 }
 
+void Cartridge::end() {
+    delete cart;
+    cart = 0;
+}
+
 void Cartridge::writeByte(const uint16_t addr, const uint8_t data) { cart->writeByte(addr, data); }
 uint8_t Cartridge::readByte(const uint16_t addr) { return cart->readByte(addr); }
+const uint8_t* Cartridge::getReadPointer(const uint16_t addr) { return cart->getReadPointer(addr); }
+void Cartridge::printStats() { cart->printStats(); }
+void Cartridge::saveStep() { cart->saveStep(); }
 
 void Cartridge::getGameName(char* buf) {
     char* name;
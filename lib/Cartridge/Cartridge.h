@@ -21,11 +21,21 @@
 
 class Cartridge {
    public:
-    static uint8_t begin(const char* romFile);
-    static uint8_t begin(const uint8_t* data);
+    // ROMs on the SD card are paged into romBankFrames bank frames
+    // The SD card has to be initialized with SD.begin before
+    static uint8_t begin(const char* romFile, const uint8_t romBankFrames = ROM_BANK_FRAMES);
+    // romFile is the file the image was loaded from, if any. The RAM of
+    // battery backed cartridges is kept in a save file next to it
+    static uint8_t begin(const uint8_t* data, const char* romFile = 0);
+    // Delete the cartridge and release all of its memory
+    static void end();
     static void writeByte(const uint16_t addr, const uint8_t data);
     static uint8_t readByte(const uint16_t addr);
+    static const uint8_t* getReadPointer(const uint16_t addr);
     static void getGameName(char* buf);
+    static void printStats();
+    // Write back changed save RAM, call this regularly from the main loop
+    static void saveStep();
 
    private:
     static ACartridge* cart;
@@ -0,0 +1,87 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+#include "Lz4.h"
+
+#include <string.h>
+
+// Read a length that continues in the following bytes while they are 255
+static bool readLength(const uint8_t*& src, const uint8_t* srcEnd, uint32_t& length) {
+    uint8_t extra;
+    do {
+        if (src >= srcEnd) {
+            return false;
+        }
+        extra = *src++;
+        length += extra;
+    } while (extra == 255);
+    return true;
+}
+
+uint32_t lz4Decompress(const uint8_t* src, const uint32_t srcSize, uint8_t* dst, const uint32_t dstSize) {
+    const uint8_t* srcEnd = src + srcSize;
+    uint8_t* out = dst;
+    uint8_t* outEnd = dst + dstSize;
+
+    while (src < srcEnd) {
+        // Every sequence starts with a token holding both lengths
+        const uint8_t token = *src++;
+
+        // Copy the literals
+        uint32_t length = token >> 4;
+        if (length == 15 && !readLength(src, srcEnd, length)) {
+            return 0;
+        }
+        if (length > (uint32_t)(srcEnd - src) || length > (uint32_t)(outEnd - out)) {
+            return 0;
+        }
+        memcpy(out, src, length);
+        src += length;
+        out += length;
+
+        // The last sequence only has literals
+        if (src == srcEnd) {
+            break;
+        }
+
+        // Copy the match from the output that has already been written
+        if (srcEnd - src < 2) {
+            return 0;
+        }
+        const uint16_t offset = src[0] | (src[1] << 8);
+        src += 2;
+        length = token & 0xF;
+        if (length == 15 && !readLength(src, srcEnd, length)) {
+            return 0;
+        }
+        length += 4;
+        if (offset == 0 || offset > out - dst || length > (uint32_t)(outEnd - out)) {
+            return 0;
+        }
+        const uint8_t* match = out - offset;
+        if (offset >= length) {
+            memcpy(out, match, length);
+            out += length;
+        } else {
+            // Overlapping matches repeat the last offset bytes
+            while (length--) {
+                *out++ = *match++;
+            }
+        }
+    }
+    return out - dst;
+}
@@ -0,0 +1,25 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+#pragma once
+
+#include <Arduino.h>
+
+// Decompress an LZ4 block (the raw block format, without a frame) from
+// src into dst. Returns the amount of bytes written to dst, 0 if the block
+// is corrupt or doesn't fit into dstSize bytes
+uint32_t lz4Decompress(const uint8_t* src, const uint32_t srcSize, uint8_t* dst, const uint32_t dstSize);
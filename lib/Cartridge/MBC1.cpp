@@ -20,7 +20,7 @@
 #include <Arduino.h>
 #include <stdlib.h>
 
-MBC1::MBC1(const char *romFile) : ACartridge(romFile) {
+MBC1::MBC1(File romFile, const uint8_t *header, const uint8_t romBankFrames) : ACartridge(romFile, header) {
     // Initialize the control registers
     ramEnable = 0x0;
     primaryBankBits = 0x1;  // Defaults to bank 1 on PoR
@@ -30,32 +30,8 @@ MBC1::MBC1(const char *romFile) : ACartridge(romFile) {
     // Set at least 2 ROM banks
     romBankCount = romBankCount < 2 ? 2 : romBankCount;
 
-    // Allocate memory for ROM banks
-    romBanks = (uint8_t **)malloc(romBankCount * sizeof(uint8_t *));
-    for (uint8_t i = 0; i < romBankCount; i++) {
-        romBanks[i] = (uint8_t *)malloc(ROM_BANK_SIZE * sizeof(uint8_t));
-    }
-
-    // Write the ROM data to memory
-    Serial.println("Loading ROM into memory...");
-    File dataFile = SD.open(romFile);
-    if (dataFile) {
-        for (uint8_t i = 0; i < romBankCount; i++) {
-            for (uint16_t j = 0; j < ROM_BANK_SIZE; j++) {
-                romBanks[i][j] = dataFile.read();
-            }
-        }
-    } else {
-        Serial.printf("Could not open rom file %s\n", romFile);
-    }
-    Serial.println();
-    Serial.println("ROM Loaded!");
-
-    // Allocate memory for the RAM banks
-    ramBanks = (uint8_t **)malloc(ramBankCount * sizeof(uint8_t *));
-    for (uint8_t i = 0; i < ramBankCount; i++) {
-        ramBanks[i] = (uint8_t *)malloc(ramBankSize * sizeof(uint8_t));
-    }
+    ram = initRomBanks(romBankFrames, ramSize);
+    selectRomBanks();
 }
 
 MBC1::MBC1(const uint8_t *data) : ACartridge(data) {
@@ -68,53 +44,39 @@ MBC1::MBC1(const uint8_t *data) : ACartridge(data) {
     // Set at least 2 ROM banks
     romBankCount = romBankCount < 2 ? 2 : romBankCount;
 
-    // Allocate memory for ROM banks
-    romBanks = (uint8_t **)malloc(romBankCount * sizeof(uint8_t *));
-    for (uint8_t i = 0; i < romBankCount; i++) {
-        romBanks[i] = (uint8_t *)malloc(ROM_BANK_SIZE * sizeof(uint8_t));
-    }
+    ram = initRomBanks(data, ramSize);
+    selectRomBanks();
+}
 
-    // Write the ROM data to memory
-    // This is currently intended to be used with automated tests
-    // TODO: Maybe find a solution without memcpy
-    Serial.println("Loading ROM into memory...");
-    for (uint8_t i = 0; i < romBankCount; i++) {
-        memcpy(romBanks[i], data + ROM_BANK_SIZE * i, ROM_BANK_SIZE * sizeof(uint8_t));
-    }
-    Serial.println();
-    Serial.println("ROM Loaded!");
+MBC1::~MBC1() { Serial.println("Deleting MBC1"); }
 
-    // Allocate memory for the RAM banks
-    ramBanks = (uint8_t **)malloc(ramBankCount * sizeof(uint8_t *));
-    for (uint8_t i = 0; i < ramBankCount; i++) {
-        ramBanks[i] = (uint8_t *)malloc(ramBankSize * sizeof(uint8_t));
+void MBC1::selectRomBanks() {
+    uint16_t bankZero = 0;
+    uint16_t bankSwitchable = primaryBankBits;
+    // Large ROM carts use the secondary bank bits for both regions
+    if (romBankCount > 32) {
+        bankZero = secondaryBankBits << 5;
+        bankSwitchable = (secondaryBankBits << 5) | primaryBankBits;
     }
+    romBankZero = mapRomBank(bankZero, ROM_REGION_ZERO);
+    romBankSwitchable = mapRomBank(bankSwitchable, ROM_REGION_BANKED);
 }
 
-MBC1::~MBC1() { Serial.println("Deleting MBC1"); }
+uint32_t MBC1::getRamOffset(uint16_t addr) {
+    // Mask the address with the size of the RAM bank to prevent out of
+    // bounds accesses. Some single bank MBC1 carts only have 2K of RAM
+    // per bank. Large RAM carts are all 8K per bank and use the secondary
+    // bank bits as the RAM bank
+    const uint8_t bank = ramBankCount > 1 ? secondaryBankBits : 0;
+    return (bank << RAM_BANK_SHIFT) + ((addr - CART_RAM) & (ramBankSize - 1));
+}
 
 uint8_t MBC1::readByte(uint16_t addr) {
     // Handle reads from RAM
     if (addr >= CART_RAM) {
         // Mame sure RAM is enabled and exists
         if (ramEnable && ramBankCount != 0) {
-            // If this is a large RAM cart, then use secondary bank bits as
-            // the RAM bank
-            if (ramBankCount >= 1) {
-                // Return data
-                return ramBanks[secondaryBankBits][addr - CART_RAM];
-            }
-            // If this is not a large RAM cart, then the secondary bank bits are
-            // not used for RAM bank switching
-            else {
-                // Mask the address with the size of the RAM bank to
-                // prevent out of bounds reads. Some single bank MBC1
-                // carts only have 2K of RAM per bank. Large RAM carts
-                // are all 8K per bank
-                addr = addr & (ramBankSize - 1);
-                // Read data from the first and only bank
-                return ramBanks[0][addr - CART_RAM];
-            }
+            return ram[getRamOffset(addr)];
         } else {
             // Assume that invalid reads return 0xFF. TODO Look this up.
             return 0xFF;
@@ -123,29 +85,28 @@ uint8_t MBC1::readByte(uint16_t addr) {
     }
     // Handle reads from banked cartridge ROM
     else if (addr >= CART_ROM_BANKED) {
-        // If this is a small ROM cart, then don't take the secondary bank bits into account
-        if (romBankCount <= 32) {
-            return romBanks[primaryBankBits][addr - CART_ROM_BANKED];
-        }
-        // Large ROM carts use the secondary bank bits
-        else {
-            return romBanks[((secondaryBankBits << 5) | primaryBankBits)][addr - CART_ROM_BANKED];
-        }
+        return romBankSwitchable[addr - CART_ROM_BANKED];
     }
     // Handle reads from ROM bank zero
     // I know this is not called banked ROM, but technically it can be banked
+    // on large ROM carts
     else {
-        // If this is a small ROM cart, then this region is not banked
-        if (romBankCount <= 32) {
-            // Read back from bank 0
-            return romBanks[0][addr];
-        }
-        // If this is a large ROM cart, then this region can be banked.
-        else {
-            // The secondary bank bits are shifted left five places
-            // to get the bank
-            return romBanks[(secondaryBankBits) << 5][addr];
-        }
+        return romBankZero[addr];
+    }
+}
+
+const uint8_t *MBC1::getReadPointer(uint16_t addr) {
+    // Cartridge RAM is read byte by byte
+    if (addr >= CART_RAM) {
+        return 0;
+    }
+    // Banked cartridge ROM
+    else if (addr >= CART_ROM_BANKED) {
+        return romBankSwitchable + (addr - CART_ROM_BANKED);
+    }
+    // ROM bank zero
+    else {
+        return romBankZero + addr;
     }
 }
 
@@ -154,25 +115,11 @@ void MBC1::writeByte(uint16_t addr, uint8_t data) {
     if (addr >= CART_RAM) {
         // Make sure RAM is enabled and it exists
         if (ramEnable && ramBankCount > 0) {
-            // Mask the address with the size of a RAM bank
-            addr = addr & (ramBankSize - 1);
-            // If this is a large RAM cart, then use secondary bank bits as
-            // the RAM bank
-            if (ramBankCount > 1) {
-                // Write the data
-                ramBanks[secondaryBankBits][addr - CART_RAM] = data;
-                return;
-            }
-            // If this is not a large RAM cart, then the secondary bank bits are
-            // not used for RAM bank switching
-            else {
-                // Write the data to the first and only bank
-                ramBanks[0][addr - CART_RAM] = data;
-                return;
-            }
-        } else {
-            return;
+            uint8_t *location = ram + getRamOffset(addr);
+            *location = data;
+            ramWritten(location);
         }
+        return;
     }
     // Handle writes to control registers
     // This write function ensures that all data written to control registers
@@ -199,6 +146,7 @@ void MBC1::writeByte(uint16_t addr, uint8_t data) {
             // TODO: This will break on 72, 80, and 96 bank carts
             // I'm not sure if the MBC1 even supports those bank
             // sizes, so I'm not dealing with this yet.
+            selectRomBanks();
             return;
         }
         // Handle large RAM carts
@@ -212,12 +160,13 @@ void MBC1::writeByte(uint16_t addr, uint8_t data) {
         return;
     }
     // Manipulate primary bank bits control register
-    else {
+    else if (addr >= MBC1_PRIMARY_BANK_REG) {
         // Mask off data to be 5 bits
         data = data & 0x1F;
         // Writes of 0x0 default to 0x1
         if (data == 0x0) {
             primaryBankBits = 0x1;
+            selectRomBanks();
             return;
         }
         // Mask off the primary bank bits so the game can't
@@ -226,15 +175,17 @@ void MBC1::writeByte(uint16_t addr, uint8_t data) {
         // TODO: This will break on 72, 80, and 96 bank carts
         // I'm not sure if the MBC1 even supports those bank
         // sizes, so I'm not dealing with this yet.
+        selectRomBanks();
         return;
     }
     // Manipulate RAM enable control register
-    if (addr >= MBC1_RAM_ENABLE_REG) {
+    else {
         // If 0xA is in the lower 4 bits, enable RAM
         if ((data & 0xF) == 0xA) {
             ramEnable = 1;
         } else {
             ramEnable = 0;
+            ramDisabled();
         }
         return;
     }
@@ -29,11 +29,12 @@
 
 class MBC1 : public ACartridge {
    public:
-    MBC1(const char* romFile);
+    MBC1(File romFile, const uint8_t* header, const uint8_t romBankFrames);
     MBC1(const uint8_t* data);
     ~MBC1();
     uint8_t readByte(uint16_t addr) override;
     void writeByte(uint16_t addr, uint8_t data) override;
+    const uint8_t* getReadPointer(uint16_t addr) override;
 
    private:
     // Enable/Disable the RAM
@@ -45,9 +46,13 @@ class MBC1 : public ACartridge {
     // Select simple ROM banking or advanced ROM banking
     uint8_t bankModeSelect;
 
-    // TODO: Allocate these in PSRAM
-    // ROM banks
-    uint8_t** romBanks;
-    // RAM Banks 0x0 - 0x03
-    uint8_t** ramBanks;
+    // Look up the banks selected by the bank registers
+    void selectRomBanks();
+
+    // The banks currently mapped to 0x0000 - 0x3FFF and 0x4000 - 0x7FFF
+    const uint8_t* romBankZero;
+    const uint8_t* romBankSwitchable;
+
+    // Offset of an address in the selected RAM bank
+    uint32_t getRamOffset(uint16_t addr);
 };
\ No newline at end of file
@@ -20,52 +20,73 @@
 #include <Arduino.h>
 #include <stdlib.h>
 
-MBC2::MBC2(const char *romFile) : ACartridge(romFile) {
+MBC2::MBC2(File romFile, const uint8_t *header) : ACartridge(romFile, header) {
     // Initialize the control registers
     ramEnable = 0x0;
     romBankSelect = 0x1;  // Defaults to bank 1 on PoR
 
-    // Allocate memory for ROM banks
-    romBanks = (uint8_t **)malloc(romBankCount * sizeof(uint8_t *));
-    for (uint8_t i = 0; i < romBankCount; i++) {
-        romBanks[i] = (uint8_t *)malloc(ROM_BANK_SIZE * sizeof(uint8_t));
-    }
+    // The header doesn't declare the RAM that is built into the MBC2
+    ramSize = MBC2_CART_RAM_TOP - CART_RAM;
 
-    // Allocate memory for the only RAM bank
-    // Technically this could be cut in half since the MBC2 only uses 4
+    // Allocate memory for the ROM banks and the only RAM bank
+    // Technically the RAM could be cut in half since the MBC2 only uses 4
     // bits of ROM per address, but that would probably slow things down
     // and we have plenty of RAM.
-    ramBank = (uint8_t *)malloc(MBC2_CART_RAM_TOP - CART_RAM * sizeof(uint8_t));
+    if (allocateArena(romBankCount * ROM_BANK_SIZE + ramSize) == 0) {
+        return;
+    }
+    rom = arena;
+    ram = arena + romBankCount * ROM_BANK_SIZE;
+    memset(ram, 0, ramSize);
+
+    // Write the ROM data to memory
+    valid = loadRom(rom, romBankCount * ROM_BANK_SIZE);
 }
 
 MBC2::~MBC2() { Serial.println("Deleting MBC2"); }
 
 uint8_t MBC2::readByte(uint16_t addr) {
     // Handle reads from RAM
-    if (addr >= CART_RAM && addr <= MBC2_CART_RAM_TOP) {
+    if (addr >= CART_RAM && addr < MBC2_CART_RAM_TOP) {
         if (ramEnable) {
-            return ramBank[addr];
+            return ram[addr - CART_RAM];
         }
     }
     // Handle reads from banked cartridge ROM
-    else if (addr >= CART_ROM_BANKED) {
-        return romBanks[romBankSelect][addr];
+    else if (addr >= CART_ROM_BANKED && addr < CART_RAM) {
+        return rom[(romBankSelect << ROM_BANK_SHIFT) + (addr - CART_ROM_BANKED)];
     }
     // Handle reads from ROM bank zero
-    else if (addr >= CART_ROM_ZERO) {
-        return romBanks[0][addr];
+    else if (addr < CART_ROM_BANKED) {
+        return rom[addr];
     }
     Serial.printf("ERROR: Attempted to read from invalid address in MBC2 cartridge: 0x%04x\n", addr);
     return 0xFF;
 }
 
+const uint8_t *MBC2::getReadPointer(uint16_t addr) {
+    // Cartridge RAM is read byte by byte
+    if (addr >= CART_RAM) {
+        return 0;
+    }
+    // Banked cartridge ROM
+    else if (addr >= CART_ROM_BANKED) {
+        return rom + (romBankSelect << ROM_BANK_SHIFT) + (addr - CART_ROM_BANKED);
+    }
+    // ROM bank zero
+    else {
+        return rom + addr;
+    }
+}
+
 void MBC2::writeByte(uint16_t addr, uint8_t data) {
     // Handle writes to RAM
-    if (addr >= CART_RAM && addr <= MBC2_CART_RAM_TOP) {
+    if (addr >= CART_RAM && addr < MBC2_CART_RAM_TOP) {
         // Make sure RAM is enabled
         if (ramEnable) {
             // Only the bottom four bits can be written to RAM
-            ramBank[addr] = data & 0xF;
+            ram[addr - CART_RAM] = data & 0xF;
+            ramWritten(ram + (addr - CART_RAM));
             return;
         } else {
             return;
@@ -78,29 +99,32 @@ void MBC2::writeByte(uint16_t addr, uint8_t data) {
     // Manipulate the bank select register
     else if (addr >= MBC2_PRIMARY_BANK_REG && addr <= MBC2_PRIMARY_BANK_REG_TOP) {
         // LSb of upper address byte must be 1 to select a ROM bank
-        if (data & 0x100) {
+        if (addr & 0x100) {
             // Get the bank select bits from the lower 4 bits
             romBankSelect = data & 0xf;
-            // Make sure it doesn't select a bank that doesn't exist
-            if (romBankSelect > romBankCount) {
-                romBankSelect = romBankCount;
+            // Bank 0 can't be selected
+            if (romBankSelect == 0) {
+                romBankSelect = 1;
             }
+            // Make sure it doesn't select a bank that doesn't exist
+            romBankSelect &= romBankCount - 1;
             return;
         } else {
             return;
         }
     }
     // Manipulate the RAM enable register
-    else if (addr >= MBC2_RAM_ENABLE_REG) {
+    else if (addr <= MBC2_RAM_ENABLE_REG_TOP) {
         // The docs are a little unclear on how this works. I assume that
         // 0x0 will disable the RAM, any other value enables RAM, and in order
         // to change states the 0x100 bit must not be set
-        if (data & 0x100) {
+        if (addr & 0x100) {
             return;
         } else if (data) {
             ramEnable = 1;
         } else {
             ramEnable = 0;
+            ramDisabled();
         }
     }
     // MISRA
@@ -31,22 +31,18 @@
 
 class MBC2 : public ACartridge {
    public:
-    MBC2(const char* romFile);
+    MBC2(File romFile, const uint8_t* header);
     ~MBC2();
     uint8_t readByte(uint16_t addr) override;
     void writeByte(uint16_t addr, uint8_t data) override;
+    const uint8_t* getReadPointer(uint16_t addr) override;
 
    private:
     // Enable/Disable the RAM
     uint8_t ramEnable;
     // Select the ROM bank, 0x0 - 0x0F
     uint8_t romBankSelect;
-    // The amount of ROM banks in the cart
-    uint8_t romBankCount;
 
-    // TODO: Allocate these in PSRAM
-    // ROM banks
-    uint8_t** romBanks;
-    // The RAM bank
-    uint8_t* ramBank;
+    // ROM banks, in the cartridge arena
+    uint8_t* rom;
 };
\ No newline at end of file
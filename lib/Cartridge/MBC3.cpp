@@ -0,0 +1,195 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+#include "MBC3.h"
+
+#include <Arduino.h>
+#include <stdlib.h>
+
+MBC3::MBC3(File romFile, const uint8_t *header, const uint8_t romBankFrames) : ACartridge(romFile, header) {
+    ram = initRomBanks(romBankFrames, ramSize);
+    init();
+}
+
+MBC3::MBC3(const uint8_t *data) : ACartridge(data) {
+    ram = initRomBanks(data, ramSize);
+    init();
+}
+
+MBC3::~MBC3() { Serial.println("Deleting MBC3"); }
+
+void MBC3::init() {
+    // Initialize the control registers
+    ramEnable = 0x0;
+    latchState = 0xFF;
+    rtcSelect = MBC3_RTC_NONE;
+
+    // Bank zero is fixed, bank 1 is mapped to the switchable region on PoR
+    // Bank switches only swap these pointers, so reads stay a single load
+    romBankZero = mapRomBank(0, ROM_REGION_ZERO);
+    romBankSwitchable = mapRomBank(1, ROM_REGION_BANKED);
+    ramBank = ramBankCount > 0 ? ram : 0;
+
+    // The clock starts at zero when the cartridge is inserted
+    memset(rtc, 0, MBC3_RTC_REGS);
+    memset(rtcLatched, 0, MBC3_RTC_REGS);
+    rtcMillis = millis();
+}
+
+void MBC3::updateRtc() {
+    const uint32_t now = millis();
+    // A halted clock doesn't count, but the time still passes
+    if (rtc[MBC3_RTC_DAYS_HIGH] & MBC3_RTC_HALT) {
+        rtcMillis = now;
+        return;
+    }
+    const uint32_t seconds = (now - rtcMillis) / 1000;
+    if (seconds == 0) {
+        return;
+    }
+    // Keep the fraction of a second for the next update
+    rtcMillis += seconds * 1000;
+
+    uint32_t days = ((rtc[MBC3_RTC_DAYS_HIGH] & MBC3_RTC_DAY_BIT8) << 8) | rtc[MBC3_RTC_DAYS_LOW];
+    uint32_t time = rtc[MBC3_RTC_SECONDS] + rtc[MBC3_RTC_MINUTES] * 60 + rtc[MBC3_RTC_HOURS] * 3600 + seconds;
+    days += time / SECONDS_PER_DAY;
+    time %= SECONDS_PER_DAY;
+
+    rtc[MBC3_RTC_SECONDS] = time % 60;
+    rtc[MBC3_RTC_MINUTES] = (time / 60) % 60;
+    rtc[MBC3_RTC_HOURS] = time / 3600;
+    // The day counter is 9 bits, the carry bit stays set until it's cleared
+    if (days >= MBC3_RTC_MAX_DAYS) {
+        rtc[MBC3_RTC_DAYS_HIGH] |= MBC3_RTC_DAY_CARRY;
+        days %= MBC3_RTC_MAX_DAYS;
+    }
+    rtc[MBC3_RTC_DAYS_LOW] = days & 0xFF;
+    rtc[MBC3_RTC_DAYS_HIGH] = (rtc[MBC3_RTC_DAYS_HIGH] & ~MBC3_RTC_DAY_BIT8) | (days >> 8);
+}
+
+uint8_t MBC3::readByte(uint16_t addr) {
+    // Handle reads from RAM and the RTC registers
+    if (addr >= CART_RAM) {
+        if (!ramEnable) {
+            // Reads from disabled or absent cartridge RAM return 0xFF
+            return 0xFF;
+        }
+        if (ramBank) {
+            return ramBank[(addr - CART_RAM) & (ramBankSize - 1)];
+        }
+        if (rtcSelect != MBC3_RTC_NONE) {
+            return rtcLatched[rtcSelect];
+        }
+        return 0xFF;
+    }
+    // Handle reads from banked cartridge ROM
+    else if (addr >= CART_ROM_BANKED) {
+        return romBankSwitchable[addr - CART_ROM_BANKED];
+    }
+    // Handle reads from ROM bank zero
+    else {
+        return romBankZero[addr];
+    }
+}
+
+const uint8_t *MBC3::getReadPointer(uint16_t addr) {
+    // Cartridge RAM is read byte by byte
+    if (addr >= CART_RAM) {
+        return 0;
+    }
+    // Banked cartridge ROM
+    else if (addr >= CART_ROM_BANKED) {
+        return romBankSwitchable + (addr - CART_ROM_BANKED);
+    }
+    // ROM bank zero
+    else {
+        return romBankZero + addr;
+    }
+}
+
+void MBC3::writeByte(uint16_t addr, uint8_t data) {
+    // Handle writes to RAM and the RTC registers
+    if (addr >= CART_RAM) {
+        if (!ramEnable) {
+            return;
+        }
+        if (ramBank) {
+            uint8_t *location = ramBank + ((addr - CART_RAM) & (ramBankSize - 1));
+            *location = data;
+            ramWritten(location);
+        } else if (rtcSelect != MBC3_RTC_NONE) {
+            // Writes go to the running clock, bring it up to date first
+            updateRtc();
+            if (rtcSelect == MBC3_RTC_SECONDS) {
+                // Writing the seconds resets the fraction of a second
+                rtcMillis = millis();
+                data &= 0x3F;
+            } else if (rtcSelect == MBC3_RTC_MINUTES) {
+                data &= 0x3F;
+            } else if (rtcSelect == MBC3_RTC_HOURS) {
+                data &= 0x1F;
+            } else if (rtcSelect == MBC3_RTC_DAYS_HIGH) {
+                data &= MBC3_RTC_DAY_BIT8 | MBC3_RTC_HALT | MBC3_RTC_DAY_CARRY;
+            }
+            rtc[rtcSelect] = data;
+            rtcLatched[rtcSelect] = data;
+        }
+        return;
+    }
+    // Handle writes to control registers
+    // Latch the clock when 0x00 and then 0x01 is written
+    else if (addr >= MBC3_LATCH_CLOCK_REG) {
+        if (latchState == 0x00 && data == 0x01) {
+            updateRtc();
+            memcpy(rtcLatched, rtc, MBC3_RTC_REGS);
+        }
+        latchState = data;
+        return;
+    }
+    // Select a RAM bank or an RTC register
+    else if (addr >= MBC3_RAM_BANK_REG) {
+        if (data >= MBC3_RTC_SELECT && data < MBC3_RTC_SELECT + MBC3_RTC_REGS) {
+            rtcSelect = data - MBC3_RTC_SELECT;
+            ramBank = 0;
+        } else if (data < 0x4 && ramBankCount > 0) {
+            rtcSelect = MBC3_RTC_NONE;
+            ramBank = ram + ((data & (ramBankCount - 1)) << RAM_BANK_SHIFT);
+        }
+        return;
+    }
+    // Select the 7 bit ROM bank, writes of 0x0 default to 0x1
+    else if (addr >= MBC3_ROM_BANK_REG) {
+        data = data & 0x7F;
+        if (data == 0x0) {
+            data = 0x1;
+        }
+        // Mask off the bank so the game can't access out of bounds memory
+        romBankSwitchable = mapRomBank(data & (romBankCount - 1), ROM_REGION_BANKED);
+        return;
+    }
+    // Manipulate RAM enable control register
+    else {
+        // If 0xA is in the lower 4 bits, enable RAM and the RTC registers
+        if ((data & 0xF) == 0xA) {
+            ramEnable = 1;
+        } else {
+            ramEnable = 0;
+            ramDisabled();
+        }
+        return;
+    }
+}
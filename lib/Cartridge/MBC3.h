@@ -0,0 +1,80 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+#pragma once
+
+#include <Arduino.h>
+
+#include "ACartridge.h"
+
+// Control Register Addresses
+#define MBC3_RAM_ENABLE_REG  0x0000
+#define MBC3_ROM_BANK_REG    0x2000
+#define MBC3_RAM_BANK_REG    0x4000
+#define MBC3_LATCH_CLOCK_REG 0x6000
+
+// RTC registers, selected with the values 0x08 - 0x0C of the RAM bank register
+#define MBC3_RTC_SECONDS    0x0
+#define MBC3_RTC_MINUTES    0x1
+#define MBC3_RTC_HOURS      0x2
+#define MBC3_RTC_DAYS_LOW   0x3
+#define MBC3_RTC_DAYS_HIGH  0x4
+#define MBC3_RTC_REGS       5
+#define MBC3_RTC_SELECT     0x08
+#define MBC3_RTC_NONE       0xFF
+#define MBC3_RTC_DAY_BIT8   0x01
+#define MBC3_RTC_HALT       0x40
+#define MBC3_RTC_DAY_CARRY  0x80
+#define MBC3_RTC_MAX_DAYS   512
+#define SECONDS_PER_DAY     86400
+
+class MBC3 : public ACartridge {
+   public:
+    MBC3(File romFile, const uint8_t* header, const uint8_t romBankFrames);
+    MBC3(const uint8_t* data);
+    ~MBC3();
+    uint8_t readByte(uint16_t addr) override;
+    void writeByte(uint16_t addr, uint8_t data) override;
+    const uint8_t* getReadPointer(uint16_t addr) override;
+
+   private:
+    // Enable/Disable the RAM and the RTC registers
+    uint8_t ramEnable;
+    // Last value written to the latch clock register
+    uint8_t latchState;
+    // Selected RTC register, MBC3_RTC_NONE if a RAM bank is selected
+    uint8_t rtcSelect;
+
+    // Set up the control registers and the banks selected on power up
+    void init();
+
+    // The banks currently mapped to 0x0000 - 0x3FFF and 0x4000 - 0x7FFF
+    const uint8_t* romBankZero;
+    const uint8_t* romBankSwitchable;
+
+    // The RAM bank currently mapped to 0xA000 - 0xBFFF, 0 if there is none
+    uint8_t* ramBank;
+
+    // The running clock and the copy of it the game reads after latching
+    uint8_t rtc[MBC3_RTC_REGS];
+    uint8_t rtcLatched[MBC3_RTC_REGS];
+    // Time the running clock was last advanced to in milliseconds
+    uint32_t rtcMillis;
+
+    // Advance the running clock by the time that passed since the last update
+    void updateRtc();
+};
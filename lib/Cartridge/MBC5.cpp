@@ -0,0 +1,127 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+#include "MBC5.h"
+
+#include <Arduino.h>
+#include <stdlib.h>
+
+MBC5::MBC5(File romFile, const uint8_t *header, const uint8_t romBankFrames) : ACartridge(romFile, header) {
+    ram = initRomBanks(romBankFrames, ramSize);
+    init();
+}
+
+MBC5::MBC5(const uint8_t *data) : ACartridge(data) {
+    ram = initRomBanks(data, ramSize);
+    init();
+}
+
+MBC5::~MBC5() { Serial.println("Deleting MBC5"); }
+
+void MBC5::init() {
+    // Initialize the control registers
+    ramEnable = 0x0;
+    romBankSelect = 0x1;  // Defaults to bank 1 on PoR
+
+    // Bank switches only swap these pointers, so reads stay a single load
+    // no matter how large the ROM is
+    romBankZero = mapRomBank(0, ROM_REGION_ZERO);
+    romBankSwitchable = mapRomBank(romBankSelect, ROM_REGION_BANKED);
+    ramBank = ramBankCount > 0 ? ram : 0;
+}
+
+uint8_t MBC5::readByte(uint16_t addr) {
+    // Handle reads from RAM
+    if (addr >= CART_RAM) {
+        // Make sure RAM is enabled and exists
+        if (ramEnable && ramBank) {
+            return ramBank[(addr - CART_RAM) & (ramBankSize - 1)];
+        } else {
+            // Reads from disabled or absent cartridge RAM return 0xFF
+            return 0xFF;
+        }
+    }
+    // Handle reads from banked cartridge ROM
+    else if (addr >= CART_ROM_BANKED) {
+        return romBankSwitchable[addr - CART_ROM_BANKED];
+    }
+    // Handle reads from ROM bank zero
+    else {
+        return romBankZero[addr];
+    }
+}
+
+const uint8_t *MBC5::getReadPointer(uint16_t addr) {
+    // Cartridge RAM is read byte by byte
+    if (addr >= CART_RAM) {
+        return 0;
+    }
+    // Banked cartridge ROM
+    else if (addr >= CART_ROM_BANKED) {
+        return romBankSwitchable + (addr - CART_ROM_BANKED);
+    }
+    // ROM bank zero
+    else {
+        return romBankZero + addr;
+    }
+}
+
+void MBC5::writeByte(uint16_t addr, uint8_t data) {
+    // Handle writes to RAM
+    if (addr >= CART_RAM) {
+        // Make sure RAM is enabled and it exists
+        if (ramEnable && ramBank) {
+            uint8_t *location = ramBank + ((addr - CART_RAM) & (ramBankSize - 1));
+            *location = data;
+            ramWritten(location);
+        }
+        return;
+    }
+    // Handle writes to control registers
+    // Writes to 0x6000 - 0x7FFF are ignored
+    else if (addr >= MBC5_RAM_BANK_TOP) {
+        return;
+    }
+    // Select the RAM bank, bit 3 drives the motor of rumble carts
+    else if (addr >= MBC5_RAM_BANK_REG) {
+        if (ramBankCount > 0) {
+            ramBank = ram + ((data & 0xF & (ramBankCount - 1)) << RAM_BANK_SHIFT);
+        }
+        return;
+    }
+    // Select bit 8 of the ROM bank
+    else if (addr >= MBC5_ROM_BANK_HIGH_REG) {
+        romBankSelect = ((data & 0x1) << 8) | (romBankSelect & 0xFF);
+    }
+    // Select the lower 8 bits of the ROM bank
+    else if (addr >= MBC5_ROM_BANK_LOW_REG) {
+        romBankSelect = (romBankSelect & 0x100) | data;
+    }
+    // Manipulate RAM enable control register
+    else {
+        // If 0xA is in the lower 4 bits, enable RAM
+        if ((data & 0xF) == 0xA) {
+            ramEnable = 1;
+        } else {
+            ramEnable = 0;
+            ramDisabled();
+        }
+        return;
+    }
+    // Mask off the bank so the game can't access out of bounds memory
+    romBankSwitchable = mapRomBank(romBankSelect & (romBankCount - 1), ROM_REGION_BANKED);
+}
@@ -0,0 +1,55 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+#pragma once
+
+#include <Arduino.h>
+
+#include "ACartridge.h"
+
+// Control Register Addresses
+#define MBC5_RAM_ENABLE_REG    0x0000
+#define MBC5_ROM_BANK_LOW_REG  0x2000
+#define MBC5_ROM_BANK_HIGH_REG 0x3000
+#define MBC5_RAM_BANK_REG      0x4000
+#define MBC5_RAM_BANK_TOP      0x6000
+
+class MBC5 : public ACartridge {
+   public:
+    MBC5(File romFile, const uint8_t* header, const uint8_t romBankFrames);
+    MBC5(const uint8_t* data);
+    ~MBC5();
+    uint8_t readByte(uint16_t addr) override;
+    void writeByte(uint16_t addr, uint8_t data) override;
+    const uint8_t* getReadPointer(uint16_t addr) override;
+
+   private:
+    // Enable/Disable the RAM
+    uint8_t ramEnable;
+    // The 9 bit ROM bank number, unlike the other MBCs bank 0 can be selected
+    uint16_t romBankSelect;
+
+    // Set up the control registers and the banks selected on power up
+    void init();
+
+    // The banks currently mapped to 0x0000 - 0x3FFF and 0x4000 - 0x7FFF
+    const uint8_t* romBankZero;
+    const uint8_t* romBankSwitchable;
+
+    // The RAM bank currently mapped to 0xA000 - 0xBFFF, 0 if there is none
+    uint8_t* ramBank;
+};
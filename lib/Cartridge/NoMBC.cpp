@@ -22,47 +22,33 @@
 #include <SPI.h>
 #include <stdlib.h>
 
-NoMBC::NoMBC(const char *romFile) : ACartridge(romFile) {
-    // Allocate space for the ROM, always 2 banks
-    rom = (uint8_t *)malloc(ROM_BANK_SIZE * 2 * sizeof(uint8_t));
+NoMBC::NoMBC(File romFile, const uint8_t *header) : ACartridge(romFile, header) {
+    // Allocate space for the ROM, always 2 banks, and the RAM, if any
+    if (allocateArena(ROM_BANK_SIZE * 2 + ramSize) == 0) {
+        return;
+    }
 
     // Write the ROM data to memory
-    Serial.println("Loading ROM into memory...");
-    File dataFile = SD.open(romFile);
-    if (dataFile) {
-        for (uint16_t i = 0; i < ROM_BANK_SIZE * 2; i++) {
-            rom[i] = dataFile.read();
-        }
-    } else {
-        Serial.printf("Could not open rom file %s\n", romFile);
-    }
-    Serial.println();
-    Serial.println("ROM Loaded!");
-    // Allocate space for the RAM, if any
-    if (ramSize != 0x0) {
-        Serial.println("Initializing RAM...");
-        ram = (uint8_t *)malloc(ramSize * sizeof(uint8_t));
-        memset(ram, 0x0, ramSize);
-        Serial.println("RAM Initialized!");
-    }
+    valid = loadRom(arena, ROM_BANK_SIZE * 2);
+    rom = arena;
+
+    ram = arena + ROM_BANK_SIZE * 2;
+    memset(ram, 0x0, ramSize);
 }
 
 NoMBC::NoMBC(const uint8_t *data) : ACartridge(data) {
-    // Allocate space for the ROM, always 2 banks
-    rom = (uint8_t *)malloc(ROM_BANK_SIZE * 2 * sizeof(uint8_t));
-
-    // Write the ROM data to memory
-    // This is currently intended to be used with automated tests
-    // TODO: Maybe find a solution without memcpy
-    Serial.println("Loading ROM into memory...");
-    memcpy(rom, data, ROM_BANK_SIZE * 2 * sizeof(uint8_t));
-    Serial.println();
-    Serial.println("ROM Loaded!");
+    // The ROM is read straight from the image, which has to stay around
+    // as long as the cartridge
+    Serial.println("Running ROM from memory");
+    rom = data;
 
     // Allocate space for the RAM, if any
     if (ramSize != 0x0) {
         Serial.println("Initializing RAM...");
-        ram = (uint8_t *)malloc(ramSize * sizeof(uint8_t));
+        ram = allocateArena(ramSize);
+        if (ram == 0) {
+            return;
+        }
         memset(ram, 0x0, ramSize);
         Serial.println("RAM Initialized!");
     }
@@ -73,7 +59,8 @@ NoMBC::~NoMBC() { Serial.println("Deleting NoMBC"); }
 uint8_t NoMBC::readByte(uint16_t addr) {
     if (addr >= CART_RAM) {
         if (ramSize != 0) {
-            return ram[addr - CART_RAM];
+            // Carts with 2K of RAM mirror it over the whole RAM region
+            return ram[(addr - CART_RAM) & (ramSize - 1)];
         } else {
             // TODO: Assume undefined RAM reads return 0xFF. Look this up
             return 0xFF;
@@ -83,12 +70,22 @@ uint8_t NoMBC::readByte(uint16_t addr) {
     }
 }
 
+const uint8_t *NoMBC::getReadPointer(uint16_t addr) {
+    // Cartridge RAM is read byte by byte
+    if (addr >= CART_RAM) {
+        return 0;
+    }
+    return rom + addr;
+}
+
 void NoMBC::writeByte(uint16_t addr, uint8_t data) {
     // Handle writes to cartridge RAM
     if (addr >= CART_RAM) {
         // Make sure the RAM exists before we write to it
         if (ramSize != 0) {
-            ram[(addr & (ramSize - 1)) - CART_RAM] = data;
+            uint8_t *location = ram + ((addr - CART_RAM) & (ramSize - 1));
+            *location = data;
+            ramWritten(location);
             return;
         } else {
             return;
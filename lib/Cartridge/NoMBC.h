@@ -23,13 +23,13 @@
 
 class NoMBC : public ACartridge {
    public:
-    NoMBC(const char* romFile);
+    NoMBC(File romFile, const uint8_t* header);
     NoMBC(const uint8_t* data);
     ~NoMBC();
     uint8_t readByte(uint16_t addr) override;
     void writeByte(uint16_t addr, uint8_t data) override;
+    const uint8_t* getReadPointer(uint16_t addr) override;
 
    private:
-    uint8_t* rom;
-    uint8_t* ram;
+    const uint8_t* rom;
 };
@@ -0,0 +1,123 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+#include "RomBankCache.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+RomBankCache::RomBankCache(File file, RomContainer* container, const uint16_t bankCount, const uint8_t frameCount, uint8_t* frames)
+    : file(file), container(container), bankCount(bankCount), frameCount(getFrameCount(bankCount, frameCount)), frames(frames) {
+    for (uint8_t i = 0; i < this->frameCount; i++) {
+        frameBanks[i] = ROM_BANK_NONE;
+        frameUsed[i] = 0;
+    }
+    memset(bankFrames, ROM_FRAME_NONE, sizeof(bankFrames));
+    selectedBanks[ROM_REGION_ZERO] = ROM_BANK_NONE;
+    selectedBanks[ROM_REGION_BANKED] = ROM_BANK_NONE;
+    selectCount = 0;
+
+    hits = 0;
+    misses = 0;
+    loadTime = 0;
+    maxLoadTime = 0;
+
+    Serial.printf("Paging ROM banks through %i frames (%i KB)\n", this->frameCount, this->frameCount * ROM_BANK_SIZE / 1024);
+}
+
+RomBankCache::~RomBankCache() { file.close(); }
+
+uint8_t RomBankCache::getFrameCount(const uint16_t bankCount, const uint8_t frameCount) {
+    // Two frames are always selected, so at least a third one is needed
+    // to page in anything else. No more frames than banks are needed
+    uint16_t count = frameCount < 3 ? 3 : frameCount;
+    if (count > bankCount) {
+        count = bankCount;
+    }
+    return count;
+}
+
+const uint8_t* RomBankCache::selectBank(const uint16_t bank, const uint8_t region) {
+    // The previously selected bank of this region can be evicted now
+    selectedBanks[region] = bank;
+
+    uint8_t frame = bankFrames[bank];
+    if (frame == ROM_FRAME_NONE) {
+        misses++;
+        frame = loadBank(bank);
+    } else {
+        hits++;
+    }
+    frameUsed[frame] = ++selectCount;
+    return frames + frame * ROM_BANK_SIZE;
+}
+
+uint8_t* RomBankCache::mapAllBanks() {
+    if (frameCount < bankCount) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < frameCount; i++) {
+        frameBanks[i] = i;
+        bankFrames[i] = i;
+    }
+    return frames;
+}
+
+uint8_t RomBankCache::loadBank(const uint16_t bank) {
+    // Find the least recently used frame. Empty frames were never used
+    uint8_t frame = ROM_FRAME_NONE;
+    for (uint8_t i = 0; i < frameCount; i++) {
+        if (frameBanks[i] != ROM_BANK_NONE && (frameBanks[i] == selectedBanks[ROM_REGION_ZERO] || frameBanks[i] == selectedBanks[ROM_REGION_BANKED])) {
+            continue;
+        }
+        if (frame == ROM_FRAME_NONE || frameUsed[i] < frameUsed[frame]) {
+            frame = i;
+        }
+    }
+
+    // Evict the bank that was in the frame
+    if (frameBanks[frame] != ROM_BANK_NONE) {
+        bankFrames[frameBanks[frame]] = ROM_FRAME_NONE;
+    }
+
+    const uint32_t start = micros();
+    uint8_t* data = frames + frame * ROM_BANK_SIZE;
+    bool loaded;
+    if (container) {
+        loaded = container->readBank(bank, data);
+    } else {
+        loaded = file.seek(bank * ROM_BANK_SIZE) && file.read(data, ROM_BANK_SIZE) == ROM_BANK_SIZE;
+    }
+    if (!loaded) {
+        Serial.printf("Could not load ROM bank %i\n", bank);
+        memset(data, 0xFF, ROM_BANK_SIZE);
+    }
+    const uint32_t time = micros() - start;
+    loadTime += time;
+    if (time > maxLoadTime) {
+        maxLoadTime = time;
+    }
+
+    frameBanks[frame] = bank;
+    bankFrames[bank] = frame;
+    return frame;
+}
+
+void RomBankCache::printStats() {
+    Serial.printf("ROM bank cache: %lu hits, %lu misses, %lu us average load time, %lu us max load time\n", (unsigned long)hits, (unsigned long)misses,
+                  (unsigned long)(misses ? loadTime / misses : 0), (unsigned long)maxLoadTime);
+}
@@ -0,0 +1,97 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+#pragma once
+
+#include <Arduino.h>
+#include <SD.h>
+
+#include "CartHelpers.h"
+#include "RomContainer.h"
+
+// The two ROM regions a bank can be selected for
+#define ROM_REGION_ZERO   0
+#define ROM_REGION_BANKED 1
+
+// Marks frames without a bank and banks without a frame
+#define ROM_BANK_NONE  0xFFFF
+#define ROM_FRAME_NONE 0xFF
+
+// Limit of the frame tables
+#define ROM_MAX_FRAMES 0xFF
+
+/**
+ * ROM bank cache
+ *
+ * Keeps a fixed amount of 16KB bank frames in RAM and loads ROM banks
+ * from the ROM file on the SD card when they are selected. If all frames
+ * are in use, the least recently selected bank is evicted. The banks that
+ * are currently selected for the two ROM regions are never evicted.
+ *
+ * Banks are looked up when the MBC switches banks, not on every access,
+ * so the cache doesn't add any cost to ROM reads.
+ */
+class RomBankCache {
+   public:
+    // The frames are owned by the cartridge, there have to be
+    // getFrameCount(bankCount, frameCount) * ROM_BANK_SIZE bytes of them
+    // Banks are decompressed from the container if there is one
+    RomBankCache(File file, RomContainer* container, const uint16_t bankCount, const uint8_t frameCount, uint8_t* frames);
+    ~RomBankCache();
+
+    // The amount of frames actually used for the given amount of banks
+    static uint8_t getFrameCount(const uint16_t bankCount, const uint8_t frameCount);
+
+    // Select a bank for one of the ROM regions and return its frame
+    const uint8_t* selectBank(const uint16_t bank, const uint8_t region);
+
+    // If there is a frame for every bank, assign them in order and return
+    // the frames to load the whole ROM into. Returns 0 otherwise
+    uint8_t* mapAllBanks();
+
+    void printStats();
+
+   private:
+    // Load a bank into the least recently used frame that isn't selected
+    uint8_t loadBank(const uint16_t bank);
+
+    // The ROM file on the SD card
+    File file;
+    // The container of compressed ROM files, owned by the cartridge
+    RomContainer* container;
+    uint16_t bankCount;
+    uint8_t frameCount;
+
+    // Bank frames, frameCount * ROM_BANK_SIZE bytes
+    // Frame n starts at frames + n * ROM_BANK_SIZE
+    uint8_t* frames;
+    // The bank held by each frame
+    uint16_t frameBanks[ROM_MAX_FRAMES];
+    // When each frame was last selected
+    uint32_t frameUsed[ROM_MAX_FRAMES];
+    // The frame of each bank
+    uint8_t bankFrames[ROM_MAX_BANKS];
+    // Banks currently selected for each ROM region
+    uint16_t selectedBanks[2];
+    uint32_t selectCount;
+
+    // Statistics
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t loadTime;
+    uint32_t maxLoadTime;
+};
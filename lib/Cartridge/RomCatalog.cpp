@@ -0,0 +1,181 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+#include "RomCatalog.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+#include "RomContainer.h"
+
+rom_catalog_entry_t RomCatalog::entries[ROM_CATALOG_MAX_ROMS];
+uint16_t RomCatalog::count = 0;
+char RomCatalog::dir[ROM_CATALOG_NAME_SIZE] = ROM_CATALOG_DIR;
+
+uint16_t RomCatalog::begin(const char* dir) {
+    const uint32_t start = micros();
+    strncpy(RomCatalog::dir, dir, ROM_CATALOG_NAME_SIZE - 1);
+    RomCatalog::dir[ROM_CATALOG_NAME_SIZE - 1] = 0;
+
+    const bool loaded = load();
+
+    // Walk the directory and build the new catalog at the front. Entries
+    // of the old catalog that haven't been matched yet stay behind it
+    File root = SD.open(dir);
+    uint16_t current = 0;
+    uint16_t pending = count;
+    uint16_t updated = 0;
+    while (root && current < ROM_CATALOG_MAX_ROMS) {
+        File file = root.openNextFile();
+        if (!file) {
+            break;
+        }
+        if (file.isDirectory() || !isRomFile(file.name()) || strlen(file.name()) >= ROM_CATALOG_NAME_SIZE) {
+            file.close();
+            continue;
+        }
+        // Files with the same name and size are taken from the catalog
+        const int16_t index = findEntry(file.name(), current, pending);
+        if (index >= 0 && entries[index].fileSize == file.size()) {
+            const rom_catalog_entry_t entry = entries[index];
+            entries[index] = entries[current];
+            entries[current] = entry;
+            current++;
+        } else {
+            // Keep the unmatched entry in the way for a later file. If the
+            // catalog is full, it's dropped and read again if needed
+            if (current < pending && pending < ROM_CATALOG_MAX_ROMS) {
+                entries[pending++] = entries[current];
+            }
+            if (readEntry(file, &entries[current])) {
+                strcpy(entries[current].file, file.name());
+                current++;
+                updated++;
+            }
+        }
+        file.close();
+    }
+    root.close();
+
+    // Files that are gone or changed leave unmatched entries behind
+    const bool changed = !loaded || updated != 0 || current != count;
+    count = current;
+    if (changed) {
+        save();
+    }
+    Serial.printf("ROM catalog: %i ROMs, %i headers read in %lu us\n", count, updated, (unsigned long)(micros() - start));
+    return count;
+}
+
+uint16_t RomCatalog::getCount() { return count; }
+
+const rom_catalog_entry_t* RomCatalog::getEntry(const uint16_t index) { return index < count ? &entries[index] : 0; }
+
+void RomCatalog::getPath(const uint16_t index, char* path, const uint16_t size) {
+    const uint16_t length = strlen(dir);
+    snprintf(path, size, length && dir[length - 1] == '/' ? "%s%s" : "%s/%s", dir, index < count ? entries[index].file : "");
+}
+
+void RomCatalog::printCatalog() {
+    for (uint16_t i = 0; i < count; i++) {
+        const rom_catalog_entry_t* entry = &entries[i];
+        Serial.printf("%3i %-16s %-24s %4lu KB %s\n", i, entry->title, lookupCartType(entry->cartCode), (unsigned long)(lookupRomSize(entry->romCode) / 1024),
+                      entry->file);
+    }
+}
+
+bool RomCatalog::load() {
+    char path[ROM_CATALOG_NAME_SIZE * 2];
+    snprintf(path, sizeof(path), "%s/%s", dir, ROM_CATALOG_FILE);
+    count = 0;
+    File file = SD.open(path);
+    if (!file) {
+        return false;
+    }
+    // The catalog is only valid if it was written with the same entries
+    uint8_t header[8];
+    uint16_t entryCount = 0;
+    bool valid = file.read(header, sizeof(header)) == sizeof(header) && memcmp(header, ROM_CATALOG_MAGIC, 4) == 0 &&
+                 (header[4] | (header[5] << 8)) == sizeof(rom_catalog_entry_t);
+    if (valid) {
+        entryCount = header[6] | (header[7] << 8);
+        valid = entryCount <= ROM_CATALOG_MAX_ROMS && file.read(entries, entryCount * sizeof(rom_catalog_entry_t)) == (int)(entryCount * sizeof(rom_catalog_entry_t));
+    }
+    file.close();
+    count = valid ? entryCount : 0;
+    return valid;
+}
+
+void RomCatalog::save() {
+    char path[ROM_CATALOG_NAME_SIZE * 2];
+    snprintf(path, sizeof(path), "%s/%s", dir, ROM_CATALOG_FILE);
+    // Write a new file, so no stale entries remain at the end
+    SD.remove(path);
+    File file = SD.open(path, FILE_WRITE);
+    if (!file) {
+        Serial.printf("Could not write ROM catalog %s\n", path);
+        return;
+    }
+    uint8_t header[8];
+    memcpy(header, ROM_CATALOG_MAGIC, 4);
+    header[4] = sizeof(rom_catalog_entry_t) & 0xFF;
+    header[5] = sizeof(rom_catalog_entry_t) >> 8;
+    header[6] = count & 0xFF;
+    header[7] = count >> 8;
+    file.write(header, sizeof(header));
+    file.write((const uint8_t*)entries, count * sizeof(rom_catalog_entry_t));
+    file.close();
+}
+
+bool RomCatalog::isRomFile(const char* name) {
+    const char* extension = strrchr(name, '.');
+    if (extension == 0) {
+        return false;
+    }
+    return strcasecmp(extension, ".gb") == 0 || strcasecmp(extension, ".gbc") == 0 || strcasecmp(extension, ".gbz") == 0;
+}
+
+bool RomCatalog::readEntry(File file, rom_catalog_entry_t* entry) {
+    uint8_t header[CART_HEADER_SIZE];
+    if (file.read(header, CART_HEADER_SIZE) != CART_HEADER_SIZE) {
+        return false;
+    }
+    entry->compressed = RomContainer::isContainer(header);
+    if (entry->compressed && !RomContainer::readHeader(file, header)) {
+        return false;
+    }
+    entry->fileSize = file.size();
+    entry->cartCode = header[CART_CODE];
+    entry->romCode = header[ROM_CODE];
+    entry->ramCode = header[RAM_CODE];
+    entry->mbcType = lookupMbcType(entry->cartCode);
+    entry->headerChecksum = header[CART_HEADER_CHECKSUM];
+    entry->globalChecksum = (header[CART_GLOBAL_CHECKSUM] << 8) | header[CART_GLOBAL_CHECKSUM + 1];
+    // Titles are padded with zeros, but can also fill all 16 bytes
+    memcpy(entry->title, header + CART_NAME, 16);
+    entry->title[16] = 0;
+    return true;
+}
+
+int16_t RomCatalog::findEntry(const char* name, const uint16_t first, const uint16_t end) {
+    for (uint16_t i = first; i < end; i++) {
+        if (strcmp(entries[i].file, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
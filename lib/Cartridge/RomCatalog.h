@@ -0,0 +1,86 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+#pragma once
+
+#include <Arduino.h>
+#include <SD.h>
+
+#include "CartHelpers.h"
+
+// The catalog is kept in the ROM directory
+#define ROM_CATALOG_DIR   "/"
+#define ROM_CATALOG_FILE  "ROMS.CAT"
+#define ROM_CATALOG_MAGIC "GBRC"
+// Limits of the catalog
+#define ROM_CATALOG_MAX_ROMS  128
+#define ROM_CATALOG_NAME_SIZE 64
+
+// What the catalog knows about a ROM file, stored as is in the catalog file
+typedef struct {
+    // Size of the file, it's read again if the size changes
+    uint32_t fileSize;
+    uint16_t globalChecksum;
+    uint8_t headerChecksum;
+    uint8_t cartCode;
+    uint8_t romCode;
+    uint8_t ramCode;
+    uint8_t mbcType;
+    // 1 for compressed ROM containers
+    uint8_t compressed;
+    // Null terminated title from the header
+    char title[17];
+    // Name of the file in the ROM directory
+    char file[ROM_CATALOG_NAME_SIZE];
+} rom_catalog_entry_t;
+
+/**
+ * ROM catalog
+ *
+ * Caches the headers of all ROM files in a directory in a single catalog
+ * file, so the ROMs can be listed without opening every file. When the
+ * catalog is loaded, it's compared to the directory and only the headers
+ * of new files and files that changed size are read again.
+ */
+class RomCatalog {
+   public:
+    // Load the catalog of a directory and bring it up to date
+    // The SD card has to be initialized with SD.begin before
+    // Returns the amount of ROMs
+    static uint16_t begin(const char* dir = ROM_CATALOG_DIR);
+    static uint16_t getCount();
+    static const rom_catalog_entry_t* getEntry(const uint16_t index);
+    // Get the path of a ROM to pass to Cartridge::begin
+    static void getPath(const uint16_t index, char* path, const uint16_t size);
+    static void printCatalog();
+
+   private:
+    static rom_catalog_entry_t entries[ROM_CATALOG_MAX_ROMS];
+    static uint16_t count;
+    static char dir[ROM_CATALOG_NAME_SIZE];
+
+    // Read and write the catalog file
+    static bool load();
+    static void save();
+
+    // Check the extension of a file for ROMs and ROM containers
+    static bool isRomFile(const char* name);
+    // Read the header of a ROM file into an entry
+    static bool readEntry(File file, rom_catalog_entry_t* entry);
+    // Find the entry of a file among the entries first to end
+    static int16_t findEntry(const char* name, const uint16_t first, const uint16_t end);
+};
@@ -0,0 +1,102 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+#include "RomContainer.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+#include "Lz4.h"
+
+static uint32_t readUint32(const uint8_t* data) { return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24); }
+
+bool RomContainer::isContainer(const uint8_t* data) { return memcmp(data, ROM_CONTAINER_MAGIC, ROM_CONTAINER_MAGIC_SIZE) == 0; }
+
+bool RomContainer::readHeader(File file, uint8_t* header) {
+    return file.seek(ROM_CONTAINER_HEADER) && file.read(header, CART_HEADER_SIZE) == CART_HEADER_SIZE;
+}
+
+RomContainer::RomContainer(File file, const uint16_t bankCount) : file(file), bankCount(bankCount), valid(false) {
+    banksRead = 0;
+    decompressTime = 0;
+    maxDecompressTime = 0;
+
+    uint8_t info[ROM_CONTAINER_HEADER];
+    if (!file.seek(0) || file.read(info, ROM_CONTAINER_HEADER) != ROM_CONTAINER_HEADER) {
+        return;
+    }
+    // The container has to hold all banks the header asks for
+    const uint16_t containerBanks = info[ROM_CONTAINER_BANKS] | (info[ROM_CONTAINER_BANKS + 1] << 8);
+    if (!isContainer(info) || containerBanks < bankCount || bankCount > ROM_MAX_BANKS) {
+        Serial.println("Invalid ROM container");
+        return;
+    }
+
+    // Read the offsets of the banks that are used and where the last one
+    // ends. The banks follow each other, so that is the start of the next
+    // bank or the end of the data
+    uint8_t entry[4];
+    file.seek(ROM_CONTAINER_INDEX);
+    for (uint16_t bank = 0; bank <= bankCount; bank++) {
+        if (file.read(entry, 4) != 4) {
+            Serial.println("Invalid ROM container index");
+            return;
+        }
+        offsets[bank] = readUint32(entry);
+    }
+    valid = true;
+
+    // Only the banks in use are counted
+    const uint32_t romSize = (uint32_t)bankCount * ROM_BANK_SIZE;
+    const uint32_t packedSize = offsets[bankCount] - offsets[0];
+    Serial.printf("ROM container: %lu KB packed into %lu KB (%lu%%)\n", (unsigned long)(romSize / 1024), (unsigned long)(packedSize / 1024),
+                  (unsigned long)((uint64_t)packedSize * 100 / (romSize + 1)));
+}
+
+bool RomContainer::isValid() { return valid; }
+
+bool RomContainer::readBank(const uint16_t bank, uint8_t* dst) {
+    if (bank >= bankCount) {
+        return false;
+    }
+    const uint32_t size = offsets[bank + 1] - offsets[bank];
+    if (size > ROM_BANK_SIZE) {
+        return false;
+    }
+    // Banks that didn't compress are read straight into place
+    if (size == ROM_BANK_SIZE) {
+        return file.seek(offsets[bank]) && file.read(dst, ROM_BANK_SIZE) == ROM_BANK_SIZE;
+    }
+    if (!file.seek(offsets[bank]) || file.read(buffer, size) != (int)size) {
+        return false;
+    }
+
+    const uint32_t start = micros();
+    const bool ok = lz4Decompress(buffer, size, dst, ROM_BANK_SIZE) == ROM_BANK_SIZE;
+    const uint32_t time = micros() - start;
+    decompressTime += time;
+    if (time > maxDecompressTime) {
+        maxDecompressTime = time;
+    }
+    banksRead++;
+    return ok;
+}
+
+void RomContainer::printStats() {
+    Serial.printf("ROM container: %lu banks decompressed, %lu us average decompression time, %lu us max decompression time\n", (unsigned long)banksRead,
+                  (unsigned long)(banksRead ? decompressTime / banksRead : 0), (unsigned long)maxDecompressTime);
+}
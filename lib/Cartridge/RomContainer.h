@@ -0,0 +1,79 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+#pragma once
+
+#include <Arduino.h>
+#include <SD.h>
+
+#include "CartHelpers.h"
+
+/**
+ * Compressed ROM container (.gbz)
+ *
+ * Layout, all numbers little endian:
+ *   0x000  "GBZ1"
+ *   0x004  uint16 amount of ROM banks
+ *   0x006  uint16 reserved, 0
+ *   0x008  uint32 uncompressed ROM size
+ *   0x00C  the uncompressed cartridge header, the first 0x150 bytes of the ROM
+ *   0x15C  uint32 file offset of each bank, followed by the end of the last bank
+ *   ...    the banks, each one an LZ4 block. Banks that don't compress are
+ *          stored as they are, which is the case if they take ROM_BANK_SIZE bytes
+ *
+ * Banks are decompressed one at a time when the bank cache or the loader
+ * asks for them, so a ROM is never held in compressed form in RAM.
+ * Containers are made with tools/gbzpack.py.
+ */
+#define ROM_CONTAINER_MAGIC       "GBZ1"
+#define ROM_CONTAINER_MAGIC_SIZE  4
+#define ROM_CONTAINER_BANKS       0x004
+#define ROM_CONTAINER_ROM_SIZE    0x008
+#define ROM_CONTAINER_HEADER      0x00C
+#define ROM_CONTAINER_INDEX       (ROM_CONTAINER_HEADER + CART_HEADER_SIZE)
+
+class RomContainer {
+   public:
+    // Check if the first bytes of a ROM file are the start of a container
+    static bool isContainer(const uint8_t* data);
+    // Read the cartridge header stored in a container
+    static bool readHeader(File file, uint8_t* header);
+
+    // Reads the index, check isValid() before using the container
+    RomContainer(File file, const uint16_t bankCount);
+    bool isValid();
+
+    // Decompress a bank into ROM_BANK_SIZE bytes of dst
+    bool readBank(const uint16_t bank, uint8_t* dst);
+
+    void printStats();
+
+   private:
+    File file;
+    uint16_t bankCount;
+    bool valid;
+
+    // File offsets of the banks, followed by the end of the last bank
+    uint32_t offsets[ROM_MAX_BANKS + 1];
+    // Compressed bank read from the file
+    uint8_t buffer[ROM_BANK_SIZE];
+
+    // Statistics
+    uint32_t banksRead;
+    uint32_t decompressTime;
+    uint32_t maxDecompressTime;
+};
@@ -0,0 +1,145 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+#include "SaveRam.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+SaveRam::SaveRam(const char* path, uint8_t* ram, const uint32_t size) : ram(ram), size(size) {
+    blockCount = (size + SAVE_BLOCK_SIZE - 1) >> SAVE_BLOCK_SHIFT;
+    memset(dirty, 0, sizeof(dirty));
+    dirtyCount = 0;
+    nextBlock = 0;
+    dirtySince = 0;
+    lastStep = 0;
+    flushRequested = false;
+
+    blocksWritten = 0;
+    runsWritten = 0;
+    maxRunTime = 0;
+
+    file = SD.open(path, FILE_WRITE);
+    if (!file) {
+        Serial.printf("Could not open save file %s, saves will be lost\n", path);
+        return;
+    }
+    const uint32_t fileSize = file.size();
+    if (fileSize >= size) {
+        file.seek(0);
+        file.read(ram, size);
+        Serial.printf("Loaded %i KB of cartridge RAM from %s\n", size / 1024, path);
+    } else {
+        // Size the new file once, so blocks can be written back anywhere
+        file.seek(fileSize);
+        for (uint32_t i = fileSize; i < size; i += SAVE_BLOCK_SIZE) {
+            const uint32_t count = size - i < SAVE_BLOCK_SIZE ? size - i : SAVE_BLOCK_SIZE;
+            file.write(ram + i, count);
+        }
+        file.flush();
+        Serial.printf("Created save file %s\n", path);
+    }
+}
+
+SaveRam::~SaveRam() {
+    flush();
+    file.close();
+}
+
+void SaveRam::markDirty(const uint8_t* location) {
+    const uint16_t block = (location - ram) >> SAVE_BLOCK_SHIFT;
+    if (dirty[block]) {
+        return;
+    }
+    if (dirtyCount == 0) {
+        dirtySince = millis();
+    }
+    dirty[block] = true;
+    dirtyCount++;
+}
+
+void SaveRam::requestFlush() {
+    if (dirtyCount != 0) {
+        flushRequested = true;
+    }
+}
+
+void SaveRam::step() {
+    if (dirtyCount == 0) {
+        return;
+    }
+    const uint32_t now = millis();
+    if (!flushRequested && now - dirtySince < SAVE_FLUSH_DELAY) {
+        return;
+    }
+    // Space out the writes, so each step only takes a fraction of a frame
+    if (now - lastStep < SAVE_STEP_INTERVAL) {
+        return;
+    }
+    lastStep = now;
+    writeRun(SAVE_STEP_BLOCKS);
+}
+
+void SaveRam::flush() {
+    while (dirtyCount != 0) {
+        writeRun(blockCount);
+    }
+}
+
+void SaveRam::writeRun(const uint16_t maxBlocks) {
+    if (!file) {
+        // Nowhere to write to, forget about the changes
+        memset(dirty, 0, sizeof(dirty));
+        dirtyCount = 0;
+        flushRequested = false;
+        return;
+    }
+
+    // Find the next dirty block and the contiguous dirty blocks after it
+    while (!dirty[nextBlock]) {
+        nextBlock = nextBlock + 1 < blockCount ? nextBlock + 1 : 0;
+    }
+    const uint16_t first = nextBlock;
+    uint16_t count = 0;
+    while (first + count < blockCount && count < maxBlocks && dirty[first + count]) {
+        dirty[first + count] = false;
+        count++;
+    }
+    dirtyCount -= count;
+    nextBlock = first + count < blockCount ? first + count : 0;
+
+    // Write the whole run at once
+    const uint32_t start = micros();
+    const uint32_t offset = first << SAVE_BLOCK_SHIFT;
+    const uint32_t runLength = (uint32_t)count << SAVE_BLOCK_SHIFT;
+    const uint32_t length = runLength < size - offset ? runLength : size - offset;
+    file.seek(offset);
+    file.write(ram + offset, length);
+    if (dirtyCount == 0) {
+        // Commit the file once everything is written back
+        file.flush();
+        flushRequested = false;
+    }
+    const uint32_t time = micros() - start;
+    maxRunTime = time > maxRunTime ? time : maxRunTime;
+    blocksWritten += count;
+    runsWritten++;
+}
+
+void SaveRam::printStats() {
+    Serial.printf("Save RAM: %i blocks written in %i runs, %i us max run time, %i blocks dirty\n", blocksWritten, runsWritten, maxRunTime, dirtyCount);
+}
@@ -0,0 +1,92 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+#pragma once
+
+#include <Arduino.h>
+#include <SD.h>
+
+// Cartridge RAM is tracked and written back in blocks of 512 bytes
+#define SAVE_BLOCK_SHIFT 9
+#define SAVE_BLOCK_SIZE  (1 << SAVE_BLOCK_SHIFT)
+// 128KB, the largest cartridge RAM
+#define SAVE_MAX_BLOCKS 256
+
+// Most blocks written back at once by a single step
+#define SAVE_STEP_BLOCKS 2
+// Time between two steps that write to the SD card in ms
+#define SAVE_STEP_INTERVAL 16
+// Time RAM can stay dirty before it's written back without a request in ms
+#define SAVE_FLUSH_DELAY 2000
+
+/**
+ * Battery backed cartridge RAM
+ *
+ * Keeps cartridge RAM in a save file on the SD card. The file is read
+ * into RAM when the cartridge is inserted. RAM writes only mark their
+ * 512 byte block dirty, dirty blocks are written back in small runs of
+ * contiguous blocks by step(), so writing back never stalls a frame.
+ *
+ * Dirty blocks are written back when the game disables the RAM, once
+ * they have been dirty for SAVE_FLUSH_DELAY, and when the cartridge is
+ * removed.
+ */
+class SaveRam {
+   public:
+    // The RAM is owned by the cartridge, it's loaded from the save file
+    // if there is one, otherwise the file is created
+    SaveRam(const char* path, uint8_t* ram, const uint32_t size);
+    // Writes back all dirty blocks
+    ~SaveRam();
+
+    // Mark the block of a RAM location as changed
+    void markDirty(const uint8_t* location);
+    // Write back all dirty blocks as soon as possible, e.g. when the game
+    // disables the RAM after saving
+    void requestFlush();
+    // Write back the next run of dirty blocks if it's due
+    void step();
+    // Write back all dirty blocks at once
+    void flush();
+
+    void printStats();
+
+   private:
+    // Write back the next run of at most maxBlocks contiguous dirty blocks
+    void writeRun(const uint16_t maxBlocks);
+
+    // The save file on the SD card
+    File file;
+    uint8_t* ram;
+    uint32_t size;
+    uint16_t blockCount;
+
+    // Blocks changed since they were last written back
+    bool dirty[SAVE_MAX_BLOCKS];
+    uint16_t dirtyCount;
+    // Block the next run starts looking for dirty blocks at
+    uint16_t nextBlock;
+    // When the oldest dirty block was marked and when the last run was written
+    uint32_t dirtySince;
+    uint32_t lastStep;
+    bool flushRequested;
+
+    // Statistics
+    uint32_t blocksWritten;
+    uint32_t runsWritten;
+    uint32_t maxRunTime;
+};
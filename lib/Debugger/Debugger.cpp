@@ -0,0 +1,145 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+/**
+ * How the Debugger works
+ *
+ * Execution breakpoints are checked by the CPU before each instruction,
+ * but only while at least one breakpoint is set.
+ *
+ * Watchpoints don't add any checks to the regular memory access path.
+ * Instead, Memory routes every page that contains a watchpoint through a
+ * checking handler, while all other pages keep their direct mapping.
+ * Watching an I/O register like LCDC routes the I/O page through the
+ * Debugger, which then breaks on every change of that register.
+ */
+
+#include "Debugger.h"
+
+#include "CPU.h"
+#include "Memory.h"
+
+bool Debugger::breakpointsEnabled = false;
+break_handler_t Debugger::breakHandler = Debugger::defaultBreakHandler;
+
+uint16_t Debugger::breakpoints[DEBUGGER_MAX_BREAKPOINTS] = {0};
+uint8_t Debugger::breakpointCount = 0;
+
+uint16_t Debugger::watchpoints[DEBUGGER_MAX_WATCHPOINTS] = {0};
+uint8_t Debugger::watchpointTypes[DEBUGGER_MAX_WATCHPOINTS] = {0};
+uint8_t Debugger::watchpointCount = 0;
+
+bool Debugger::addBreakpoint(const uint16_t pc) {
+    if (breakpointCount >= DEBUGGER_MAX_BREAKPOINTS) {
+        Serial.printf("Too many breakpoints, ignoring 0x%04x\n", pc);
+        return false;
+    }
+    breakpoints[breakpointCount++] = pc;
+    breakpointsEnabled = true;
+    return true;
+}
+
+void Debugger::removeBreakpoint(const uint16_t pc) {
+    for (uint8_t i = 0; i < breakpointCount; i++) {
+        if (breakpoints[i] == pc) {
+            breakpoints[i--] = breakpoints[--breakpointCount];
+        }
+    }
+    breakpointsEnabled = breakpointCount > 0;
+}
+
+bool Debugger::addWatchpoint(const uint16_t location, const uint8_t type) {
+    if (watchpointCount >= DEBUGGER_MAX_WATCHPOINTS) {
+        Serial.printf("Too many watchpoints, ignoring 0x%04x\n", location);
+        return false;
+    }
+    watchpoints[watchpointCount] = location;
+    watchpointTypes[watchpointCount] = type;
+    watchpointCount++;
+    updatePage(location >> 8);
+    return true;
+}
+
+void Debugger::removeWatchpoint(const uint16_t location) {
+    for (uint8_t i = 0; i < watchpointCount; i++) {
+        if (watchpoints[i] == location) {
+            watchpointCount--;
+            watchpoints[i] = watchpoints[watchpointCount];
+            watchpointTypes[i] = watchpointTypes[watchpointCount];
+            i--;
+        }
+    }
+    updatePage(location >> 8);
+}
+
+void Debugger::clear() {
+    breakpointCount = 0;
+    breakpointsEnabled = false;
+    while (watchpointCount > 0) {
+        removeWatchpoint(watchpoints[0]);
+    }
+}
+
+void Debugger::updatePage(const uint8_t page) {
+    bool read = false, write = false;
+    for (uint8_t i = 0; i < watchpointCount; i++) {
+        if ((watchpoints[i] >> 8) == page) {
+            read |= (watchpointTypes[i] & WATCH_READ) != 0;
+            write |= (watchpointTypes[i] & WATCH_WRITE) != 0;
+        }
+    }
+    Memory::watchPage(page, read, write);
+}
+
+void Debugger::checkBreakpoint(const uint16_t pc) {
+    for (uint8_t i = 0; i < breakpointCount; i++) {
+        if (breakpoints[i] == pc) {
+            breakHandler(BREAK_EXEC, pc, 0);
+            return;
+        }
+    }
+}
+
+void Debugger::checkRead(const uint16_t location, const uint8_t data) {
+    for (uint8_t i = 0; i < watchpointCount; i++) {
+        if (watchpoints[i] == location && (watchpointTypes[i] & WATCH_READ)) {
+            breakHandler(BREAK_READ, location, data);
+            return;
+        }
+    }
+}
+
+void Debugger::checkWrite(const uint16_t location, const uint8_t data) {
+    for (uint8_t i = 0; i < watchpointCount; i++) {
+        if (watchpoints[i] == location && (watchpointTypes[i] & WATCH_WRITE)) {
+            breakHandler(BREAK_WRITE, location, data);
+            return;
+        }
+    }
+}
+
+void Debugger::defaultBreakHandler(const uint8_t reason, const uint16_t location, const uint8_t data) {
+    if (reason == BREAK_EXEC) {
+        Serial.printf("Breakpoint at %04x\n", location);
+    } else if (reason == BREAK_READ) {
+        Serial.printf("Watchpoint: read %02x from %04x\n", data, location);
+    } else {
+        Serial.printf("Watchpoint: write %02x to %04x\n", data, location);
+    }
+    CPU::stopAndRestart();
+}
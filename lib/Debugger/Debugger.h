@@ -0,0 +1,82 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#pragma once
+
+#include <Arduino.h>
+
+// Maximum amount of breakpoints and watchpoints
+#define DEBUGGER_MAX_BREAKPOINTS 16
+#define DEBUGGER_MAX_WATCHPOINTS 16
+
+// Watchpoint types
+#define WATCH_READ  0x1
+#define WATCH_WRITE 0x2
+
+// Reasons passed to the break handler
+#define BREAK_EXEC  0x0
+#define BREAK_READ  0x1
+#define BREAK_WRITE 0x2
+
+// Called whenever a breakpoint or watchpoint is hit
+// location: The PC for execution breakpoints, the accessed address for watchpoints
+// data: The byte read or written, 0 for execution breakpoints
+typedef void (*break_handler_t)(const uint8_t reason, const uint16_t location, const uint8_t data);
+
+class Debugger {
+   public:
+    // Set when at least one execution breakpoint exists
+    // This is the only check the CPU pays for per instruction
+    static bool breakpointsEnabled;
+
+    // Handler for hits, defaults to dumping the CPU state and halting
+    static break_handler_t breakHandler;
+
+    // Break before executing the instruction at pc
+    static bool addBreakpoint(const uint16_t pc);
+    static void removeBreakpoint(const uint16_t pc);
+
+    // Break on reads and/or writes of a location, e.g. MEM_LCDC
+    // type: WATCH_READ and/or WATCH_WRITE
+    static bool addWatchpoint(const uint16_t location, const uint8_t type);
+    static void removeWatchpoint(const uint16_t location);
+
+    static void clear();
+
+    // Called by the CPU before executing the instruction at pc
+    static void checkBreakpoint(const uint16_t pc);
+
+    // Called by Memory for accesses to watched pages
+    static void checkRead(const uint16_t location, const uint8_t data);
+    static void checkWrite(const uint16_t location, const uint8_t data);
+
+   protected:
+    static uint16_t breakpoints[DEBUGGER_MAX_BREAKPOINTS];
+    static uint8_t breakpointCount;
+
+    static uint16_t watchpoints[DEBUGGER_MAX_WATCHPOINTS];
+    static uint8_t watchpointTypes[DEBUGGER_MAX_WATCHPOINTS];
+    static uint8_t watchpointCount;
+
+    // Update the page routing in Memory for the page of a location
+    static void updatePage(const uint8_t page);
+
+    static void defaultBreakHandler(const uint8_t reason, const uint16_t location, const uint8_t data);
+
+   private:
+};
@@ -0,0 +1,323 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include "Display.h"
+
+#include <string.h>
+
+#include <atomic>
+
+#ifdef PLATFORM_NATIVE
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#else
+#include <EventResponder.h>
+#include <SPI.h>
+#endif
+
+display_frame_t Display::frames[3];
+uint8_t Display::drawing = 0;
+uint8_t Display::sending = 1;
+FT81x *Display::ft81x = 0;
+bool Display::displayValid = false;
+bool Display::colorsPending = false;
+uint8_t Display::sendLine = 0;
+uint64_t Display::sentLineHashes[144] = {0};
+uint16_t Display::sentColors[PPU_SLOT_COLORS * PPU_PALETTE_SLOTS] = {0};
+uint8_t Display::chunkBuffer[DISPLAY_CHUNK_LINES * 160] = {0};
+uint32_t Display::chunkOffset = 0;
+const uint8_t *Display::chunkData = 0;
+uint32_t Display::chunkSize = 0;
+uint32_t Display::presentedFrames = 0, Display::sentFrames = 0, Display::supersededFrames = 0, Display::sentLines = 0, Display::sentPalettes = 0;
+
+// Index of the ready frame, with DISPLAY_FRAME_FRESH set until it's taken
+static std::atomic<uint8_t> ready(2);
+// Set while a frame is being sent or the bus is locked
+static std::atomic<bool> busy(false);
+static bool started = false;
+
+#ifdef PLATFORM_NATIVE
+// The worker sleeps until a frame is presented
+static std::thread worker;
+static std::mutex wakeupMutex;
+static std::condition_variable wakeup;
+static std::atomic<bool> running(false);
+
+static void sendFrames() {
+    while (running) {
+        Display::kick();
+        std::unique_lock<std::mutex> lock(wakeupMutex);
+        // A frame presented before the wait is picked up after a short time
+        wakeup.wait_for(lock, std::chrono::milliseconds(1));
+    }
+}
+#else
+static uint8_t csPin = 0;
+static EventResponder transferDone;
+
+// Select the FT81x and write the address of a transfer, bit 7 of the
+// first byte marks writes
+static void beginTransfer(const uint32_t address, const bool write) {
+    digitalWriteFast(csPin, LOW);
+    SPI.transfer((write ? 0x80 : 0x00) | ((address >> 16) & 0x3F));
+    SPI.transfer((address >> 8) & 0xFF);
+    SPI.transfer(address & 0xFF);
+}
+
+// Write the address of a transfer to the FT81x and send the data by DMA
+static void startChunk(const uint32_t offset, const uint8_t *data, const uint32_t size) {
+    beginTransfer(offset, true);
+    SPI.transfer(data, NULL, size, transferDone);
+}
+#endif
+
+void Display::begin(FT81x &ft81x, const uint8_t csPin) {
+    Display::ft81x = &ft81x;
+    started = true;
+#ifdef PLATFORM_NATIVE
+    running = true;
+    worker = std::thread(sendFrames);
+#else
+    ::csPin = csPin;
+    transferDone.attachImmediate([](EventResponderRef event) {
+        digitalWriteFast(::csPin, HIGH);
+        if (nextChunk()) {
+            startChunk(chunkOffset, chunkData, chunkSize);
+            return;
+        }
+        SPI.endTransaction();
+        endFrame();
+        kick();
+    });
+#endif
+}
+
+void Display::end() {
+    if (!started) {
+        return;
+    }
+#ifdef PLATFORM_NATIVE
+    // Send the last frame before stopping the worker
+    running = false;
+    wakeup.notify_one();
+    worker.join();
+    kick();
+#else
+    lockBus();
+    unlockBus();
+#endif
+    started = false;
+}
+
+void Display::presentFrame() {
+    presentedFrames++;
+    // Swap the drawn frame with the ready one, the PPU continues in the
+    // previous ready frame
+    const uint8_t previous = ready.exchange(drawing | DISPLAY_FRAME_FRESH);
+    if (previous & DISPLAY_FRAME_FRESH) {
+        supersededFrames++;
+    }
+    drawing = previous & DISPLAY_FRAME_INDEX;
+    if (!started) {
+        return;
+    }
+#ifdef PLATFORM_NATIVE
+    wakeup.notify_one();
+#else
+    kick();
+#endif
+}
+
+void Display::lockBus() {
+    bool expected = false;
+    while (!busy.compare_exchange_weak(expected, true)) {
+        expected = false;
+    }
+}
+
+void Display::unlockBus() {
+    busy = false;
+    kick();
+}
+
+bool Display::takeFrame() {
+    bool expected = false;
+    if (!busy.compare_exchange_strong(expected, true)) {
+        return false;
+    }
+    if (ready.load() & DISPLAY_FRAME_FRESH) {
+        // Give the sent frame back in exchange for the ready one
+        sending = ready.exchange(sending) & DISPLAY_FRAME_INDEX;
+        return true;
+    }
+    busy = false;
+    return false;
+}
+
+void Display::kick() {
+    // Loop in case a frame is presented while the bus is released
+    while (started && takeFrame()) {
+        beginFrame();
+#ifdef PLATFORM_NATIVE
+        while (nextChunk()) {
+            ft81x->writeGRAM(chunkOffset, chunkSize, chunkData);
+        }
+        endFrame();
+#else
+        if (nextChunk()) {
+            SPI.beginTransaction(FT81x_SPI_SETTINGS);
+            startChunk(chunkOffset, chunkData, chunkSize);
+            // The rest of the frame is sent from the interrupt
+            return;
+        }
+        endFrame();
+#endif
+    }
+}
+
+void Display::beginFrame() {
+    const display_frame_t &frame = frames[sending];
+    const uint16_t colorCount = frame.slots * PPU_SLOT_COLORS;
+    sendLine = 0;
+    colorsPending = false;
+    // Lines that haven't changed use the same slots as the lines of
+    // this frame, so only the slots used by this frame are compared
+    if (!displayValid || memcmp(frame.colors, sentColors, colorCount * sizeof(uint16_t)) != 0) {
+        memcpy(sentColors, frame.colors, colorCount * sizeof(uint16_t));
+        // The display looks up the colors, so a palette change is just a
+        // palette upload
+        colorsPending = true;
+    }
+}
+
+bool Display::nextChunk() {
+    const display_frame_t &frame = frames[sending];
+    if (colorsPending) {
+        colorsPending = false;
+        chunkOffset = PPU_PALETTE_OFFSET;
+        chunkData = (const uint8_t *)sentColors;
+        chunkSize = frame.slots * PPU_SLOT_COLORS * sizeof(uint16_t);
+        sentPalettes++;
+        return true;
+    }
+
+    while (sendLine < 144 && displayValid && frame.lineHashes[sendLine] == sentLineHashes[sendLine]) {
+        sendLine++;
+    }
+    if (sendLine == 144) {
+        return false;
+    }
+
+    // Convert the run of changed lines that fits into a chunk
+    const uint8_t first = sendLine;
+    uint8_t lines = 0;
+    while (sendLine < 144 && lines < DISPLAY_CHUNK_LINES && (!displayValid || frame.lineHashes[sendLine] != sentLineHashes[sendLine])) {
+        convertLine(frame.pixels + 80 * sendLine, frame.lineSlots[sendLine], chunkBuffer + 160 * lines);
+        sentLineHashes[sendLine] = frame.lineHashes[sendLine];
+        lines++;
+        sendLine++;
+    }
+    chunkOffset = PPU_FRAME_OFFSET + 160 * first;
+    chunkData = chunkBuffer;
+    chunkSize = 160 * lines;
+    sentLines += lines;
+    return true;
+}
+
+void Display::convertLine(const uint8_t *packed, const uint8_t slot, uint8_t *pixels) {
+    // The palette indices of a slot follow each other
+    const uint8_t base = slot * PPU_SLOT_COLORS;
+    for (uint8_t x = 0; x < 80; x++) {
+        pixels[2 * x] = base + (packed[x] & 0x0F);
+        pixels[2 * x + 1] = base + (packed[x] >> 4);
+    }
+}
+
+void Display::endFrame() {
+    displayValid = true;
+    sentFrames++;
+    busy = false;
+}
+
+void Display::swapScreen() {
+    // The coprocessor has to be done with the display list before it can
+    // be extended. REG_CMD_DL points behind its last command
+    ft81x->waitForCommandBuffer();
+    const uint32_t end = readMemory32(FT81x_REG_CMD_DL);
+    // Draw the palette indices scaled by 3 with the colors of the palette.
+    // Bitmaps are multiplied with the current color, so it's set to white
+    const uint32_t list[] = {
+        DISPLAY_DL_COLOR_RGB(255, 255, 255),
+        DISPLAY_DL_COLOR_A(255),
+        DISPLAY_DL_BITMAP_HANDLE(0),
+        DISPLAY_DL_BITMAP_SOURCE(PPU_FRAME_OFFSET),
+        DISPLAY_DL_BITMAP_LAYOUT(DISPLAY_BITMAP_LAYOUT_PALETTED565, 160, 144),
+        DISPLAY_DL_BITMAP_LAYOUT_H(160, 144),
+        DISPLAY_DL_BITMAP_SIZE(FT81x_BITMAP_SIZE_NEAREST, 480, 432),
+        DISPLAY_DL_BITMAP_SIZE_H(480, 432),
+        DISPLAY_DL_PALETTE_SOURCE(PPU_PALETTE_OFFSET),
+        // The transform maps screen pixels to bitmap pixels in 8.8 fixed point
+        DISPLAY_DL_BITMAP_TRANSFORM_A(256 / 3),
+        DISPLAY_DL_BITMAP_TRANSFORM_E(256 / 3),
+        DISPLAY_DL_BEGIN_BITMAPS,
+        DISPLAY_DL_VERTEX2II(0, 0, 0, 0),
+        DISPLAY_DL_END,
+        DISPLAY_DL_DISPLAY,
+    };
+    writeMemory(FT81x_RAM_DL + end, (const uint8_t *)list, sizeof(list));
+    const uint32_t swap = FT81x_DLSWAP_FRAME;
+    writeMemory(FT81x_REG_DLSWAP, (const uint8_t *)&swap, sizeof(swap));
+}
+
+void Display::writeMemory(const uint32_t address, const uint8_t *data, const uint32_t size) {
+#ifdef PLATFORM_NATIVE
+    ft81x->writeMemory(address, size, data);
+#else
+    // The FT81x takes its memory little endian, like the Teensy
+    SPI.beginTransaction(FT81x_SPI_SETTINGS);
+    beginTransfer(address, true);
+    SPI.transfer(data, NULL, size);
+    digitalWriteFast(csPin, HIGH);
+    SPI.endTransaction();
+#endif
+}
+
+uint32_t Display::readMemory32(const uint32_t address) {
+#ifdef PLATFORM_NATIVE
+    return ft81x->readMemory32(address);
+#else
+    SPI.beginTransaction(FT81x_SPI_SETTINGS);
+    beginTransfer(address, false);
+    // Reads start after a dummy byte
+    SPI.transfer(0x00);
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        value |= (uint32_t)SPI.transfer(0x00) << (8 * i);
+    }
+    digitalWriteFast(csPin, HIGH);
+    SPI.endTransaction();
+    return value;
+#endif
+}
+
+void Display::printStats() {
+    Serial.printf("Display: %u frames presented, %u sent, %u superseded, %u of %u lines and %u palettes sent\n", presentedFrames, sentFrames, supersededFrames,
+                  sentLines, sentFrames * 144, sentPalettes);
+}
@@ -0,0 +1,156 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#pragma once
+
+#include <Arduino.h>
+#include <FT81x.h>
+#include <PPU.h>
+
+// The ready frame has been published and not been taken by the sender yet
+#define DISPLAY_FRAME_FRESH 0x80
+#define DISPLAY_FRAME_INDEX 0x03
+
+// Changed lines are unpacked to palette indices, a byte per pixel, and
+// sent in chunks of up to this many bytes
+#define DISPLAY_CHUNK_SIZE  1280
+#define DISPLAY_CHUNK_LINES (DISPLAY_CHUNK_SIZE / 160)
+
+// Display list commands the driver has no calls for, as described in the
+// FT81x programming guide
+#define DISPLAY_DL_DISPLAY                          0x00000000
+#define DISPLAY_DL_BITMAP_SOURCE(addr)              ((0x01UL << 24) | (addr))
+#define DISPLAY_DL_COLOR_RGB(r, g, b)               ((0x04UL << 24) | ((r) << 16) | ((g) << 8) | (b))
+#define DISPLAY_DL_BITMAP_HANDLE(handle)            ((0x05UL << 24) | (handle))
+#define DISPLAY_DL_BITMAP_LAYOUT(format, stride, h) ((0x07UL << 24) | ((format) << 19) | (((stride) % 0x400) << 9) | ((h) % 0x200))
+#define DISPLAY_DL_BITMAP_SIZE(filter, w, h)        ((0x08UL << 24) | ((filter) << 20) | (((w) % 0x200) << 9) | ((h) % 0x200))
+#define DISPLAY_DL_COLOR_A(alpha)                   ((0x10UL << 24) | (alpha))
+#define DISPLAY_DL_BITMAP_TRANSFORM_A(a)            ((0x15UL << 24) | (a))
+#define DISPLAY_DL_BITMAP_TRANSFORM_E(e)            ((0x19UL << 24) | (e))
+#define DISPLAY_DL_BEGIN_BITMAPS                    ((0x1FUL << 24) | 1)
+#define DISPLAY_DL_END                              (0x21UL << 24)
+#define DISPLAY_DL_BITMAP_LAYOUT_H(stride, h)       ((0x28UL << 24) | (((stride) >> 10) << 2) | ((h) >> 9))
+#define DISPLAY_DL_BITMAP_SIZE_H(w, h)              ((0x29UL << 24) | (((w) >> 9) << 2) | ((h) >> 9))
+#define DISPLAY_DL_PALETTE_SOURCE(addr)             ((0x2AUL << 24) | (addr))
+#define DISPLAY_DL_VERTEX2II(x, y, handle, cell)    ((0x2UL << 30) | ((x) << 21) | ((y) << 12) | ((handle) << 7) | (cell))
+
+// 8 bit palette indices into a palette of RGB565 colors
+#define DISPLAY_BITMAP_LAYOUT_PALETTED565 14
+
+// A frame drawn by the PPU, with everything needed to send it
+typedef struct {
+    // Entries of the pixels in the palette slot of their line, two pixels
+    // per byte with the left one in the low nibble
+    uint8_t pixels[80 * 144];
+    // Palette slot of every line
+    uint8_t lineSlots[144];
+    // Hashes of the lines, lines that hash like the ones the display
+    // holds aren't sent
+    uint64_t lineHashes[144];
+    // Colors of the palette slots used by the frame
+    uint16_t colors[PPU_SLOT_COLORS * PPU_PALETTE_SLOTS];
+    uint8_t slots;
+} display_frame_t;
+
+/**
+ * Sends the frames of the PPU to the display in the background
+ *
+ * The frames are triple buffered without locks. The PPU draws into one
+ * buffer, the sender reads from another one and the third one holds the
+ * latest finished frame. A finished frame is published by swapping it
+ * with the ready one, so the PPU never waits for the display. A ready
+ * frame that is replaced before the sender took it is counted as
+ * superseded. The sender only sends the lines that have changed since
+ * the frame the display holds, and the palette if it has changed.
+ *
+ * The display looks the colors of the palette indices up itself, so a
+ * palette change only costs a palette upload. The driver can't draw
+ * paletted bitmaps, so swapScreen appends them to its display list.
+ *
+ * On the Teensy, the transfers run by SPI DMA and the next one is
+ * started from the completion interrupt. The native build sends the
+ * frames from a worker thread.
+ */
+class Display {
+   public:
+    // Start sending frames to the display
+    // csPin is the chip select of the FT81x on the Teensy
+    static void begin(FT81x &ft81x, const uint8_t csPin);
+    // Send the last frame and stop the sender
+    static void end();
+
+    // Get the buffer the PPU draws the next frame into
+    static inline display_frame_t *getDrawingFrame() { return &frames[drawing]; }
+    // Hand the frame that has been drawn to the sender and continue in
+    // another buffer
+    static void presentFrame();
+
+    // Wait until no frame is sent and keep the sender from starting the
+    // next one, so the display list can be changed
+    static void lockBus();
+    static void unlockBus();
+    // Add the Game Boy screen to the display list the driver has built
+    // and show it, instead of the driver's swapScreen. The bus has to be
+    // locked while frames are sent
+    static void swapScreen();
+
+    // Start sending the ready frame unless a frame is being sent already
+    static void kick();
+
+    static void printStats();
+
+   private:
+    static display_frame_t frames[3];
+    // Index of the buffer the PPU draws into
+    static uint8_t drawing;
+    // Index of the buffer the sender reads from
+    static uint8_t sending;
+
+    static FT81x *ft81x;
+
+    // State of the frame being sent
+    static bool displayValid;
+    static bool colorsPending;
+    static uint8_t sendLine;
+    static uint64_t sentLineHashes[144];
+    static uint16_t sentColors[PPU_SLOT_COLORS * PPU_PALETTE_SLOTS];
+    // Lines are unpacked to palette indices while sending
+    static uint8_t chunkBuffer[DISPLAY_CHUNK_LINES * 160];
+
+    // The next transfer of the frame being sent
+    static uint32_t chunkOffset;
+    static const uint8_t *chunkData;
+    static uint32_t chunkSize;
+
+    static uint32_t presentedFrames, sentFrames, supersededFrames, sentLines, sentPalettes;
+
+    // Take the bus and the ready frame, false if there is nothing to send
+    // or the bus is taken
+    static bool takeFrame();
+    // Compare the colors of the frame taken with the ones the display holds
+    static void beginFrame();
+    // Step to the next transfer of the frame, false once all are done
+    static bool nextChunk();
+    // Unpack a line of the frame being sent to palette indices
+    static void convertLine(const uint8_t *packed, const uint8_t slot, uint8_t *pixels);
+    static void endFrame();
+
+    // Access the memory of the FT81x directly, outside of the driver
+    static void writeMemory(const uint32_t address, const uint8_t *data, const uint32_t size);
+    static uint32_t readMemory32(const uint32_t address);
+};
@@ -34,7 +34,7 @@ void Joypad::begin() {
 }
 
 void Joypad::joypadStep() {
-    joypad_register_t joypad = {.value = Memory::readByte(MEM_JOYPAD)};
+    joypad_register_t joypad = {.value = Memory::readByteInternal(MEM_JOYPAD)};
 
     // Handle direction key input
     // Interrupts are also handled inside this condition!
@@ -23,8 +23,12 @@
 #include <string.h>
 
 #include "APU.h"
+#include "Debugger.h"
+#include "SpriteIndex.h"
+#include "TileCache.h"
 
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
 
 uint8_t Memory::vram[0x2000] = {0};
 uint8_t vram[0x2000] = {0};
@@ -34,234 +38,491 @@ uint8_t Memory::ioreg[0x80] = {0};
 uint8_t Memory::hram[0x7F] = {0};
 uint8_t Memory::iereg = 0;
 
-void Memory::writeByteInternal(const uint16_t location, const uint8_t data, const bool internal) {
-    uint16_t d;
-    switch (location) {
-        // Handle write to Joypad registers at 0xFF00
-        // Register resides in I/O region
-        case MEM_JOYPAD:
-            if (internal) {
-                ioreg[location - MEM_IO_REGS] = data;
-            } else {
-                ioreg[location - MEM_IO_REGS] = (ioreg[location - MEM_IO_REGS] & 0xCF) | (data & 0x30);
-            }
-            break;
+bool Memory::dmaActive = false;
+uint8_t Memory::dmaIndex = 0;
+const uint8_t* Memory::dmaSource = 0;
 
-        // Handle writes to LCD Status register
-        // Resides in I/O region
-        case MEM_LCD_STATUS:
-            if (internal) {
-                ioreg[location - MEM_IO_REGS] = data;
-            } else {
-                ioreg[location - MEM_IO_REGS] = (ioreg[location - MEM_IO_REGS] & 0x07) | (data | 0xF8);
-            }
-            break;
-
-        // Handle writes to DMA transfer register
-        case MEM_DMA:
-            d = 0x0;
-            // DMA transfers occur from ROM/RAM to OAM in chunks of 0xA0 bytes
-            // The address of ROM/RAM to transfer to OAM is the data * 0x100
-            for (uint16_t s = data * 0x100; s < data * 0x100 + 0xA0; s++) {
-                oam[d] = readByte(s);
-                d++;
-            }
-            break;
-        // Handle writes to the Divider (DIV) register
-        case MEM_DIVIDER:
-            GBTimer::writeDiv(data);
-            break;
-
-        // Handle writes to the TIMA register
-        case MEM_TIMA:
-            GBTimer::writeTima(data);
-            break;
-
-        // Handle writes to the TMA Register
-        case MEM_TMA:
-            GBTimer::writeTma(data);
-            break;
-
-        // Handle writes to the GBTimer Control (TAC) Register
-        case MEM_TIMER_CONTROL:
-            GBTimer::writeTac(data);
-            break;
-
-        // Handle writes to the Interrupt Flag (IF) register
-        case MEM_IRQ_FLAG:
-            // Check for timer interrupt requests
-            if (data & IRQ_TIMER) {
-                // Send them to the timer
-                GBTimer::setInt();
+const uint8_t* Memory::readPages[0x100] = {0};
+uint8_t* Memory::writePages[0x100] = {0};
+const uint8_t* Memory::romBanks[2] = {0};
+Memory::page_read_handler_t Memory::readHandlers[0x100] = {0};
+Memory::page_write_handler_t Memory::writeHandlers[0x100] = {0};
+bool Memory::watchedReadPages[0x100] = {0};
+bool Memory::watchedWritePages[0x100] = {0};
+uint8_t Memory::lockedReadPage[0x100] = {0};
+uint8_t Memory::lockedWritePage[0x100] = {0};
+bool Memory::oamLocked = false;
+bool Memory::vramLocked = false;
+
+Memory::io_read_handler_t Memory::ioReadHandlers[0x80] = {0};
+Memory::io_write_handler_t Memory::ioWriteHandlers[0x80] = {0};
+
+template <typename Core>
+void Memory::initIoHandlers() {
+    memset(ioReadHandlers, 0, sizeof(ioReadHandlers));
+    memset(ioWriteHandlers, 0, sizeof(ioWriteHandlers));
+
+    // Interrupt flag, the timer IRQ bit lives in Timer
+    ioReadHandlers[MEM_IRQ_FLAG - MEM_IO_REGS] = readIrqFlag;
+    ioWriteHandlers[MEM_IRQ_FLAG - MEM_IO_REGS] = writeIrqFlag;
+
+    // Timer registers are owned by Timer
+    ioReadHandlers[MEM_DIVIDER - MEM_IO_REGS] = GBTimer::readDiv;
+    ioReadHandlers[MEM_TIMA - MEM_IO_REGS] = GBTimer::readTima;
+    ioReadHandlers[MEM_TMA - MEM_IO_REGS] = GBTimer::readTma;
+    ioReadHandlers[MEM_TIMER_CONTROL - MEM_IO_REGS] = GBTimer::readTac;
+    ioWriteHandlers[MEM_DIVIDER - MEM_IO_REGS] = writeDivider;
+    ioWriteHandlers[MEM_TIMA - MEM_IO_REGS] = writeTima;
+    ioWriteHandlers[MEM_TMA - MEM_IO_REGS] = writeTma;
+    ioWriteHandlers[MEM_TIMER_CONTROL - MEM_IO_REGS] = writeTimerControl;
+
+    // Registers with read only bits
+    ioWriteHandlers[MEM_JOYPAD - MEM_IO_REGS] = writeJoypad;
+    ioWriteHandlers[MEM_LCD_STATUS - MEM_IO_REGS] = writeLcdStatus;
+
+    // OAM DMA
+    ioWriteHandlers[MEM_DMA - MEM_IO_REGS] = writeDma<Core>;
+
+    // Sound length counters
+    ioWriteHandlers[MEM_SOUND_NR11 - MEM_IO_REGS] = writeSoundNR11;
+    ioWriteHandlers[MEM_SOUND_NR21 - MEM_IO_REGS] = writeSoundNR21;
+    ioWriteHandlers[MEM_SOUND_NR31 - MEM_IO_REGS] = writeSoundNR31;
+    ioWriteHandlers[MEM_SOUND_NR41 - MEM_IO_REGS] = writeSoundNR41;
+
+    // Sound channel DACs
+    ioWriteHandlers[MEM_SOUND_NR12 - MEM_IO_REGS] = writeSoundNR12;
+    ioWriteHandlers[MEM_SOUND_NR22 - MEM_IO_REGS] = writeSoundNR22;
+    ioWriteHandlers[MEM_SOUND_NR30 - MEM_IO_REGS] = writeSoundNR30;
+    ioWriteHandlers[MEM_SOUND_NR42 - MEM_IO_REGS] = writeSoundNR42;
+
+    // Sound channel triggers
+    ioWriteHandlers[MEM_SOUND_NR14 - MEM_IO_REGS] = writeSoundNR14;
+    ioWriteHandlers[MEM_SOUND_NR24 - MEM_IO_REGS] = writeSoundNR24;
+    ioWriteHandlers[MEM_SOUND_NR34 - MEM_IO_REGS] = writeSoundNR34;
+    ioWriteHandlers[MEM_SOUND_NR44 - MEM_IO_REGS] = writeSoundNR44;
+}
+
+uint8_t Memory::readIrqFlag() {
+    // Get the IRQ bit for the Timer from Timer
+    return (ioreg[MEM_IRQ_FLAG - MEM_IO_REGS] & ~IRQ_TIMER) | (GBTimer::checkInt() << 2);
+}
+
+void Memory::writeJoypad(const uint8_t data, const bool internal) {
+    if (internal) {
+        ioreg[MEM_JOYPAD - MEM_IO_REGS] = data;
+    } else {
+        ioreg[MEM_JOYPAD - MEM_IO_REGS] = (ioreg[MEM_JOYPAD - MEM_IO_REGS] & 0xCF) | (data & 0x30);
+    }
+}
+
+void Memory::writeLcdStatus(const uint8_t data, const bool internal) {
+    if (internal) {
+        ioreg[MEM_LCD_STATUS - MEM_IO_REGS] = data;
+    } else {
+        ioreg[MEM_LCD_STATUS - MEM_IO_REGS] = (ioreg[MEM_LCD_STATUS - MEM_IO_REGS] & 0x07) | (data | 0xF8);
+    }
+}
+
+template <typename Core>
+void Memory::writeDma(const uint8_t data, const bool internal) {
+    ioreg[MEM_DMA - MEM_IO_REGS] = data;
+    if (internal) {
+        return;
+    }
+    // DMA transfers occur from ROM/RAM to OAM in chunks of 0xA0 bytes
+    // The address of ROM/RAM to transfer to OAM is the data * 0x100
+    const uint16_t source = data * 0x100;
+    dmaSource = getReadPointer(source);
+    if (dmaSource == 0) {
+        // Source can't be accessed directly, copy it byte by byte
+        for (uint16_t d = 0; d < 0xA0; d++) {
+            oam[d] = readByte(source + d);
+        }
+    } else if (!Core::timedDma) {
+        memcpy(oam, dmaSource, 0xA0);
+    }
+    if (!Core::timedDma) {
+        SpriteIndex::invalidate();
+    }
+    if (Core::timedDma) {
+        // The transfer takes one cycle per byte. The source can't change
+        // while it runs since the CPU is locked out of everything but
+        // I/O and High RAM, so it's safe to stream from the resolved pointer
+        dmaIndex = 0;
+        dmaActive = true;
+        // Send all CPU accesses through the handlers which check for the
+        // bus lock
+        mapPages();
+    }
+}
+
+void Memory::dmaStep(const uint8_t cycles) {
+    if (!dmaActive) {
+        return;
+    }
+    uint8_t count = MIN(cycles, 0xA0 - dmaIndex);
+    // Sources that couldn't be resolved have been copied at the start,
+    // only the bus lock is emulated for them
+    if (dmaSource != 0) {
+        memcpy(oam + dmaIndex, dmaSource + dmaIndex, count);
+    }
+    dmaIndex += count;
+    if (dmaIndex >= 0xA0) {
+        dmaActive = false;
+        SpriteIndex::invalidate();
+        mapPages();
+    }
+}
+
+void Memory::mapPage(const uint8_t page) {
+    uint8_t* memory = 0;
+    const uint8_t* romMemory = 0;
+    // Only VRAM and Work RAM are plain host memory, cartridge ROM is read
+    // from the selected banks. Everything else has side effects
+    if (page < (MEM_VRAM >> 8)) {
+        const uint8_t* bank = romBanks[page >> 6];
+        romMemory = bank ? bank + ((page & 0x3F) << 8) : 0;
+    } else if (page >= (MEM_RAM_ECHO >> 8) && page < (MEM_SPRITE_ATTR_TABLE >> 8)) {
+        memory = wram + ((page << 8) - MEM_RAM_ECHO);
+    } else if (page >= (MEM_RAM_INTERNAL >> 8) && page < (MEM_RAM_ECHO >> 8)) {
+        memory = wram + ((page << 8) - MEM_RAM_INTERNAL);
+    } else if (page >= (MEM_VRAM >> 8) && page < (MEM_RAM_EXTERNAL >> 8)) {
+        memory = vram + ((page << 8) - MEM_VRAM);
+    }
+
+    // Writes to cartridge ROM go to the MBC registers, writes to the tile
+    // data update the tile cache
+    const uint8_t* readMemory = romMemory ? romMemory : memory;
+    uint8_t* writeMemory = isTileDataPage(page) ? 0 : memory;
+    // Memory locked by the PPU is replaced by the locked pages
+    if (isPageLocked(page)) {
+        readMemory = lockedReadPage;
+        writeMemory = lockedWritePage;
+    }
+
+    // The CPU can't access the page directly during OAM DMA
+    if (dmaActive) {
+        readMemory = 0;
+        writeMemory = 0;
+    }
+
+    readPages[page] = watchedReadPages[page] ? 0 : readMemory;
+    writePages[page] = watchedWritePages[page] ? 0 : writeMemory;
+    readHandlers[page] = watchedReadPages[page] ? readWatched : readUnmapped;
+    writeHandlers[page] = watchedWritePages[page] ? writeWatched : (isTileDataPage(page) ? writeTileData : writeUnmapped);
+}
+
+void Memory::mapPages() {
+    for (uint16_t page = 0; page < 0x100; page++) {
+        mapPage(page);
+    }
+}
+
+void Memory::mapRomBanks() {
+    for (uint8_t region = 0; region < 2; region++) {
+        const uint8_t* bank = Cartridge::getReadPointer(region ? MEM_ROM_BANK : MEM_ROM);
+        if (bank == romBanks[region]) {
+            continue;
+        }
+        romBanks[region] = bank;
+        // Bank switches are frequent, so the pages are swapped directly
+        // unless OAM DMA or the Debugger has taken them over
+        for (uint16_t page = region << 6; page < (region + 1) << 6; page++) {
+            if (dmaActive || watchedReadPages[page] || bank == 0) {
+                mapPage(page);
             } else {
-                GBTimer::clearInt();
+                readPages[page] = bank + ((page & 0x3F) << 8);
             }
-            // Don't store the Timer interrupt flag here. It's
-            // handled by Timer
-            ioreg[MEM_IRQ_FLAG - MEM_IO_REGS] = (data & ~IRQ_TIMER);
+        }
+    }
+}
 
-        // Sound length counter
-        // Resides in I/O region
-        case MEM_SOUND_NR11:
-            ioreg[location - MEM_IO_REGS] = data;
-            if (!internal) {
-                APU::loadLength1();
-            }
-            break;
-        case MEM_SOUND_NR21:
-            ioreg[location - MEM_IO_REGS] = data;
-            if (!internal) {
-                APU::loadLength2();
-            }
-            break;
-        case MEM_SOUND_NR31:
-            ioreg[location - MEM_IO_REGS] = data;
-            if (!internal) {
-                APU::loadLength3();
-            }
-            break;
-        case MEM_SOUND_NR41:
-            ioreg[location - MEM_IO_REGS] = data;
-            if (!internal) {
-                APU::loadLength4();
-            }
-            break;
+void Memory::watchPage(const uint8_t page, const bool read, const bool write) {
+    watchedReadPages[page] = read;
+    watchedWritePages[page] = write;
+    mapPage(page);
+}
 
-        // Sound channel disable
-        // Resides in I/O region
-        case MEM_SOUND_NR12:
-            ioreg[location - MEM_IO_REGS] = data;
-            if (!internal) {
-                nrx2_register_t nrx2 = {.value = data};
-                if (nrx2.bits.volume == 0) {
-                    APU::disableDac1();
-                } else {
-                    APU::enableDac1();
-                }
-            }
-            break;
-        case MEM_SOUND_NR22:
-            ioreg[location - MEM_IO_REGS] = data;
-            if (!internal) {
-                nrx2_register_t nrx2 = {.value = data};
-                if (nrx2.bits.volume == 0) {
-                    APU::disableDac2();
-                } else {
-                    APU::enableDac2();
-                }
-            }
-            break;
-        case MEM_SOUND_NR30:
-            ioreg[location - MEM_IO_REGS] = data;
-            if (!internal) {
-                if ((data & 0x80) == 0) {
-                    APU::disableDac3();
-                } else {
-                    APU::enableDac3();
-                }
-            }
-            break;
-        case MEM_SOUND_NR42:
-            ioreg[location - MEM_IO_REGS] = data;
-            if (!internal) {
-                nrx2_register_t nrx2 = {.value = data};
-                if (nrx2.bits.volume == 0) {
-                    APU::disableDac4();
-                } else {
-                    APU::enableDac4();
-                }
-            }
-            break;
+bool Memory::isPageLocked(const uint8_t page) {
+    if (page == (MEM_SPRITE_ATTR_TABLE >> 8)) {
+        return oamLocked;
+    }
+    return vramLocked && page >= (MEM_VRAM >> 8) && page < (MEM_RAM_EXTERNAL >> 8);
+}
 
-        // Sound channel enable
-        // Resides in I/O region
-        case MEM_SOUND_NR14:
-            ioreg[location - MEM_IO_REGS] = data;
-            if (!internal) {
-                if (data >> 7) {
-                    APU::triggerSquare1();
-                }
-            }
-            break;
-        case MEM_SOUND_NR24:
-            ioreg[location - MEM_IO_REGS] = data;
-            if (!internal) {
-                if (data >> 7) {
-                    APU::triggerSquare2();
-                }
-            }
-            break;
-        case MEM_SOUND_NR34:
-            ioreg[location - MEM_IO_REGS] = data;
-            if (!internal) {
-                if (data >> 7) {
-                    APU::triggerWave();
-                }
-            }
-            break;
-        case MEM_SOUND_NR44:
-            ioreg[location - MEM_IO_REGS] = data;
-            if (!internal) {
-                if (data >> 7) {
-                    APU::triggerNoise();
-                }
-            }
-            break;
+bool Memory::isTileDataPage(const uint8_t page) { return page >= (MEM_VRAM_TILES >> 8) && page < (MEM_VRAM_MAP1 >> 8); }
 
-        default:
-            // Handle writes to the IE register
-            if (location >= MEM_INT_EN_REG) {
-                iereg = data;
-            }
-            // Handle writes to High RAM
-            else if (location >= MEM_HIGH_RAM) {
-                hram[location - MEM_HIGH_RAM] = data;
-            }
-            // Handle writes to IO registers
-            else if (location >= MEM_IO_REGS) {
-                ioreg[location - MEM_IO_REGS] = data;
-            }
-            // Handle writes to unusable memory
-            else if (location >= MEM_UNUSABLE) {
-                return;
-            }
-            // Handle writes to OAM
-            else if (location >= MEM_SPRITE_ATTR_TABLE) {
-                oam[location - MEM_SPRITE_ATTR_TABLE] = data;
-            }
-            // Handle writes to echo memory
-            else if (location >= MEM_RAM_ECHO) {
-                // Just write to the beginning of internal RAM
-                wram[location - MEM_RAM_ECHO] = data;
-            }
-            // Handle writes to internal Work RAM
-            else if (location >= MEM_RAM_INTERNAL) {
-                wram[location - MEM_RAM_INTERNAL] = data;
-            }
-            // Handle writes to external cartridge RAM
-            if (location >= MEM_RAM_EXTERNAL) {
-                Cartridge::writeByte(location, data);
-            }
-            // Handle writes to VRAM
-            else if (location >= MEM_VRAM_TILES) {
-                vram[location - MEM_VRAM_TILES] = data;
-            }
-            // Handle writes to cart ROM
-            // These are usually mapped to MBC control registers in the cart
-            else if (location >= MEM_ROM) {
-                Cartridge::writeByte(location, data);
+void Memory::lockVideoMemory(const bool lockOam, const bool lockVram) {
+    if (lockOam != oamLocked) {
+        oamLocked = lockOam;
+        mapPage(MEM_SPRITE_ATTR_TABLE >> 8);
+    }
+    if (lockVram != vramLocked) {
+        vramLocked = lockVram;
+        // This runs twice per line, so the VRAM pages are swapped directly
+        // unless OAM DMA or the Debugger has taken them over
+        for (uint16_t page = (MEM_VRAM >> 8); page < (MEM_RAM_EXTERNAL >> 8); page++) {
+            if (dmaActive || watchedReadPages[page] || watchedWritePages[page]) {
+                mapPage(page);
             } else {
-                // Illegal operation
-                Serial.println("Illegal write operation on memory!");
-                Serial.printf("\tAttempted write of 0x%x to 0x%x\n", data, location);
+                uint8_t* memory = vram + ((page << 8) - MEM_VRAM);
+                readPages[page] = lockVram ? lockedReadPage : memory;
+                writePages[page] = lockVram ? lockedWritePage : (isTileDataPage(page) ? 0 : memory);
             }
-            break;
+        }
+    }
+}
+
+uint8_t Memory::readUnmapped(const uint16_t location) {
+    // Only I/O and High RAM are reachable during OAM DMA
+    if (dmaActive && location < MEM_IO_REGS) {
+        return 0xFF;
+    }
+    // Watched pages aren't swapped out while they are locked
+    if (isPageLocked(location >> 8)) {
+        return 0xFF;
     }
+    return readByteInternal(location);
 }
 
-void Memory::writeByte(const uint16_t location, const uint8_t data) { writeByteInternal(location, data, false); }
+uint8_t Memory::readWatched(const uint16_t location) {
+    const uint8_t data = readUnmapped(location);
+    Debugger::checkRead(location, data);
+    return data;
+}
 
-uint8_t Memory::readByte(const uint16_t location) {
+void Memory::writeUnmapped(const uint16_t location, const uint8_t data) {
+    // Only I/O and High RAM are reachable during OAM DMA
+    if (dmaActive && location < MEM_IO_REGS) {
+        return;
+    }
+    if (isPageLocked(location >> 8)) {
+        return;
+    }
+    writeByteInternal(location, data, false);
+}
+
+void Memory::writeTileData(const uint16_t location, const uint8_t data) {
+    // Only I/O and High RAM are reachable during OAM DMA
+    if (dmaActive || isPageLocked(location >> 8)) {
+        return;
+    }
+    vram[location - MEM_VRAM_TILES] = data;
+    TileCache::invalidate(location);
+}
+
+void Memory::writeWatched(const uint16_t location, const uint8_t data) {
+    Debugger::checkWrite(location, data);
+    writeUnmapped(location, data);
+}
+
+const uint8_t* Memory::getReadPointer(const uint16_t location) {
+    // OAM, I/O registers and High RAM are never DMA sources
+    if (location >= MEM_SPRITE_ATTR_TABLE) {
+        return 0;
+    }
+    // Echo memory
+    else if (location >= MEM_RAM_ECHO) {
+        return wram + (location - MEM_RAM_ECHO);
+    }
+    // Internal Work RAM
+    else if (location >= MEM_RAM_INTERNAL) {
+        return wram + (location - MEM_RAM_INTERNAL);
+    }
+    // External cartridge RAM
+    else if (location >= MEM_RAM_EXTERNAL) {
+        return Cartridge::getReadPointer(location);
+    }
+    // VRAM
+    else if (location >= MEM_VRAM_TILES) {
+        return vram + (location - MEM_VRAM_TILES);
+    }
+    // Cartridge ROM
+    return Cartridge::getReadPointer(location);
+}
+
+void Memory::writeDivider(const uint8_t data, const bool internal) { GBTimer::writeDiv(data); }
+
+void Memory::writeTima(const uint8_t data, const bool internal) { GBTimer::writeTima(data); }
+
+void Memory::writeTma(const uint8_t data, const bool internal) { GBTimer::writeTma(data); }
+
+void Memory::writeTimerControl(const uint8_t data, const bool internal) { GBTimer::writeTac(data); }
+
+void Memory::writeIrqFlag(const uint8_t data, const bool internal) {
+    // Check for timer interrupt requests
+    if (data & IRQ_TIMER) {
+        // Send them to the timer
+        GBTimer::setInt();
+    } else {
+        GBTimer::clearInt();
+    }
+    // Don't store the Timer interrupt flag here. It's
+    // handled by Timer
+    ioreg[MEM_IRQ_FLAG - MEM_IO_REGS] = (data & ~IRQ_TIMER);
+}
+
+void Memory::writeSoundNR11(const uint8_t data, const bool internal) {
+    ioreg[MEM_SOUND_NR11 - MEM_IO_REGS] = data;
+    if (!internal) {
+        APU::loadLength1();
+    }
+}
+
+void Memory::writeSoundNR21(const uint8_t data, const bool internal) {
+    ioreg[MEM_SOUND_NR21 - MEM_IO_REGS] = data;
+    if (!internal) {
+        APU::loadLength2();
+    }
+}
+
+void Memory::writeSoundNR31(const uint8_t data, const bool internal) {
+    ioreg[MEM_SOUND_NR31 - MEM_IO_REGS] = data;
+    if (!internal) {
+        APU::loadLength3();
+    }
+}
+
+void Memory::writeSoundNR41(const uint8_t data, const bool internal) {
+    ioreg[MEM_SOUND_NR41 - MEM_IO_REGS] = data;
+    if (!internal) {
+        APU::loadLength4();
+    }
+}
+
+void Memory::writeSoundNR12(const uint8_t data, const bool internal) {
+    ioreg[MEM_SOUND_NR12 - MEM_IO_REGS] = data;
+    if (!internal) {
+        nrx2_register_t nrx2 = {.value = data};
+        if (nrx2.bits.volume == 0) {
+            APU::disableDac1();
+        } else {
+            APU::enableDac1();
+        }
+    }
+}
+
+void Memory::writeSoundNR22(const uint8_t data, const bool internal) {
+    ioreg[MEM_SOUND_NR22 - MEM_IO_REGS] = data;
+    if (!internal) {
+        nrx2_register_t nrx2 = {.value = data};
+        if (nrx2.bits.volume == 0) {
+            APU::disableDac2();
+        } else {
+            APU::enableDac2();
+        }
+    }
+}
+
+void Memory::writeSoundNR30(const uint8_t data, const bool internal) {
+    ioreg[MEM_SOUND_NR30 - MEM_IO_REGS] = data;
+    if (!internal) {
+        if ((data & 0x80) == 0) {
+            APU::disableDac3();
+        } else {
+            APU::enableDac3();
+        }
+    }
+}
+
+void Memory::writeSoundNR42(const uint8_t data, const bool internal) {
+    ioreg[MEM_SOUND_NR42 - MEM_IO_REGS] = data;
+    if (!internal) {
+        nrx2_register_t nrx2 = {.value = data};
+        if (nrx2.bits.volume == 0) {
+            APU::disableDac4();
+        } else {
+            APU::enableDac4();
+        }
+    }
+}
+
+void Memory::writeSoundNR14(const uint8_t data, const bool internal) {
+    ioreg[MEM_SOUND_NR14 - MEM_IO_REGS] = data;
+    if (!internal && (data >> 7)) {
+        APU::triggerSquare1();
+    }
+}
+
+void Memory::writeSoundNR24(const uint8_t data, const bool internal) {
+    ioreg[MEM_SOUND_NR24 - MEM_IO_REGS] = data;
+    if (!internal && (data >> 7)) {
+        APU::triggerSquare2();
+    }
+}
+
+void Memory::writeSoundNR34(const uint8_t data, const bool internal) {
+    ioreg[MEM_SOUND_NR34 - MEM_IO_REGS] = data;
+    if (!internal && (data >> 7)) {
+        APU::triggerWave();
+    }
+}
+
+void Memory::writeSoundNR44(const uint8_t data, const bool internal) {
+    ioreg[MEM_SOUND_NR44 - MEM_IO_REGS] = data;
+    if (!internal && (data >> 7)) {
+        APU::triggerNoise();
+    }
+}
+
+void Memory::writeByteInternal(const uint16_t location, const uint8_t data, const bool internal) {
+    // Handle writes to the IE register
+    if (location >= MEM_INT_EN_REG) {
+        iereg = data;
+    }
+    // Handle writes to High RAM
+    else if (location >= MEM_HIGH_RAM) {
+        hram[location - MEM_HIGH_RAM] = data;
+    }
+    // Handle writes to IO registers
+    // Registers with side effects are dispatched to their handler,
+    // everything else is stored as is
+    else if (location >= MEM_IO_REGS) {
+        const io_write_handler_t handler = ioWriteHandlers[location - MEM_IO_REGS];
+        if (handler) {
+            handler(data, internal);
+        } else {
+            ioreg[location - MEM_IO_REGS] = data;
+        }
+    }
+    // Handle writes to unusable memory
+    else if (location >= MEM_UNUSABLE) {
+        return;
+    }
+    // Handle writes to OAM
+    else if (location >= MEM_SPRITE_ATTR_TABLE) {
+        oam[location - MEM_SPRITE_ATTR_TABLE] = data;
+        SpriteIndex::invalidate();
+    }
+    // Handle writes to echo memory
+    else if (location >= MEM_RAM_ECHO) {
+        // Just write to the beginning of internal RAM
+        wram[location - MEM_RAM_ECHO] = data;
+    }
+    // Handle writes to internal Work RAM
+    else if (location >= MEM_RAM_INTERNAL) {
+        wram[location - MEM_RAM_INTERNAL] = data;
+    }
+    // Handle writes to external cartridge RAM
+    else if (location >= MEM_RAM_EXTERNAL) {
+        Cartridge::writeByte(location, data);
+    }
+    // Handle writes to VRAM
+    else if (location >= MEM_VRAM_TILES) {
+        vram[location - MEM_VRAM_TILES] = data;
+        if (location < MEM_VRAM_MAP1) {
+            TileCache::invalidate(location);
+        }
+    }
+    // Handle writes to cart ROM
+    // These are usually mapped to MBC control registers in the cart
+    else {
+        Cartridge::writeByte(location, data);
+        mapRomBanks();
+    }
+}
+
+uint8_t Memory::readByteInternal(const uint16_t location) {
     // Handle reads of the IE register
     if (location >= MEM_INT_EN_REG) {
         return iereg;
@@ -272,31 +533,11 @@ uint8_t Memory::readByte(const uint16_t location) {
     }
     // Handle reads from IO registers
     else if (location >= MEM_IO_REGS) {
-        // Handle reads to IF register
-        if (location == MEM_IRQ_FLAG) {
-            // Get the IRQ bit for the Timer from Timer
-            return (ioreg[MEM_IRQ_FLAG - MEM_IO_REGS] & ~IRQ_TIMER) | (GBTimer::checkInt() << 2);
-        }
-        // Handle reads to the DIV register
-        else if (location == MEM_DIVIDER) {
-            return GBTimer::readDiv();
-        }
-        // Handle reads to TIMA register
-        else if (location == MEM_TIMA) {
-            return GBTimer::readTima();
-        }
-        // Handle reads to TMA register
-        else if (location == MEM_TMA) {
-            return GBTimer::readTma();
-        }
-        // Handle reads to TAC register
-        else if (location == MEM_TIMER_CONTROL) {
-            return GBTimer::readTac();
-        }
-        // Handle all other IO reg locations
-        else {
-            return ioreg[location - MEM_IO_REGS];
+        const io_read_handler_t handler = ioReadHandlers[location - MEM_IO_REGS];
+        if (handler) {
+            return handler();
         }
+        return ioreg[location - MEM_IO_REGS];
     }
     // Handle reads from unusable memory
     // TODO: Assume reads here return 0xFF. Look this up
@@ -317,7 +558,7 @@ uint8_t Memory::readByte(const uint16_t location) {
         return wram[location - MEM_RAM_INTERNAL];
     }
     // Handle reads from external cartridge RAM
-    if (location >= MEM_RAM_EXTERNAL) {
+    else if (location >= MEM_RAM_EXTERNAL) {
         return Cartridge::readByte(location);
     }
     // Handle reads from VRAM
@@ -325,18 +566,22 @@ uint8_t Memory::readByte(const uint16_t location) {
         return vram[location - MEM_VRAM_TILES];
     }
     // Handle reads from cart ROM
-    else if (location >= MEM_ROM) {
-        return Cartridge::readByte(location);
-    } else {
-        // Illegal operation
-        Serial.println("Illegal write operation on memory!");
-        Serial.printf("\tAttempted read from 0x%x\n", location);
-    }
+    return Cartridge::readByte(location);
 }
 
-void Memory::interrupt(uint8_t flag) { writeByte(MEM_IRQ_FLAG, readByte(MEM_IRQ_FLAG) | flag); }
+void Memory::interrupt(uint8_t flag) { writeByteInternal(MEM_IRQ_FLAG, readByteInternal(MEM_IRQ_FLAG) | flag, false); }
 
+template <typename Core>
 void Memory::initMemory() {
+    initIoHandlers<Core>();
+    memset(lockedReadPage, 0xFF, sizeof(lockedReadPage));
+    oamLocked = false;
+    vramLocked = false;
+    TileCache::begin();
+    romBanks[0] = Cartridge::getReadPointer(MEM_ROM);
+    romBanks[1] = Cartridge::getReadPointer(MEM_ROM_BANK);
+    mapPages();
+
     // Initialize the memory like the original
     writeByteInternal(MEM_JOYPAD, 0xCF, true);     // FF00
     writeByteInternal(MEM_SERIAL_SB, 0x00, true);  // FF01
@@ -392,4 +637,7 @@ void Memory::initMemory() {
     for (uint8_t i = 0; i < 52; i++) {
         writeByteInternal(0xFF4C + i, 0xFF, true);  // FF4C - FF7F
     }
-}
\ No newline at end of file
+}
+
+template void Memory::initMemory<FastCore>();
+template void Memory::initMemory<AccurateCore>();
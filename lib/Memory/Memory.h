@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <Accuracy.h>
 #include <Arduino.h>
 #include <Cartridge.h>
 
@@ -260,18 +261,129 @@
 
 class Memory {
    public:
+    template <typename Core>
     static void initMemory();
 
     static void writeByte(const uint16_t location, const uint8_t data);
     static void writeByteInternal(const uint16_t location, const uint8_t data, const bool internal);
     static uint8_t readByte(const uint16_t location);
+    static uint8_t readByteInternal(const uint16_t location);
+
+    // Resolve a location to host memory, 0 if it can't be accessed directly
+    static const uint8_t* getReadPointer(const uint16_t location);
+
+    // Advance a running OAM DMA transfer by the given amount of cycles
+    static void dmaStep(const uint8_t cycles);
+
+    // Route all CPU reads and/or writes of a 256 byte page through the
+    // Debugger. Unwatched pages don't pay for any checks
+    static void watchPage(const uint8_t page, const bool read, const bool write);
+
+    // Lock the CPU out of OAM and/or VRAM, called by the PPU on mode
+    // changes. Locked pages are swapped out of the page table, so CPU
+    // accesses don't check the PPU mode
+    static void lockVideoMemory(const bool lockOam, const bool lockVram);
 
     static void interrupt(const uint8_t flag);
 
     static void getTitle(char* title);
 
    protected:
+    // The tile cache decodes the tile data straight from VRAM, the sprite
+    // index reads the sprites straight from OAM and the PPU reads the tile
+    // maps straight from VRAM
+    friend class TileCache;
+    friend class SpriteIndex;
+    friend class PPU;
+
    private:
+    // Handlers for pages that aren't backed by plain host memory
+    typedef uint8_t (*page_read_handler_t)(const uint16_t location);
+    typedef void (*page_write_handler_t)(const uint16_t location, const uint8_t data);
+
+    // Page table with one entry per 256 bytes of address space
+    // CPU accesses to pages that point to host memory are direct, all
+    // other pages go through their handler
+    static const uint8_t* readPages[0x100];
+    static uint8_t* writePages[0x100];
+    static page_read_handler_t readHandlers[0x100];
+    static page_write_handler_t writeHandlers[0x100];
+
+    // Pages routed through the Debugger
+    static bool watchedReadPages[0x100];
+    static bool watchedWritePages[0x100];
+
+    // Pages swapped in for memory locked by the PPU
+    // Reads of locked memory return 0xFF, writes go to the discard page
+    static uint8_t lockedReadPage[0x100];
+    static uint8_t lockedWritePage[0x100];
+    static bool oamLocked;
+    static bool vramLocked;
+
+    static bool isPageLocked(const uint8_t page);
+    // Pages of the tile data, 0x8000 - 0x97FF. CPU writes to them go
+    // through writeTileData, so the tile cache sees them
+    static bool isTileDataPage(const uint8_t page);
+
+    static void mapPage(const uint8_t page);
+    static void mapPages();
+
+    // The cartridge ROM banks mapped to 0x0000 - 0x3FFF and 0x4000 - 0x7FFF
+    // ROM pages are read directly from them, so instruction fetches don't
+    // go through the cartridge. 0 if the cartridge can't be read directly
+    static const uint8_t* romBanks[2];
+    // Look up the ROM banks after a write to the MBC registers and remap
+    // the pages of the regions that have been switched
+    static void mapRomBanks();
+
+    static uint8_t readUnmapped(const uint16_t location);
+    static uint8_t readWatched(const uint16_t location);
+    static void writeUnmapped(const uint16_t location, const uint8_t data);
+    static void writeTileData(const uint16_t location, const uint8_t data);
+    static void writeWatched(const uint16_t location, const uint8_t data);
+
+    // Handlers for I/O registers with side effects
+    // Registers without a handler are plain accesses to ioreg
+    typedef uint8_t (*io_read_handler_t)();
+    typedef void (*io_write_handler_t)(const uint8_t data, const bool internal);
+
+    // Dispatch tables for the I/O region, indexed by location - MEM_IO_REGS
+    static io_read_handler_t ioReadHandlers[0x80];
+    static io_write_handler_t ioWriteHandlers[0x80];
+
+    template <typename Core>
+    static void initIoHandlers();
+
+    // State of a timed OAM DMA transfer
+    // While a timed transfer runs, the CPU can only access I/O and High RAM
+    static bool dmaActive;
+    static uint8_t dmaIndex;
+    static const uint8_t* dmaSource;
+
+    static uint8_t readIrqFlag();
+
+    static void writeJoypad(const uint8_t data, const bool internal);
+    static void writeLcdStatus(const uint8_t data, const bool internal);
+    template <typename Core>
+    static void writeDma(const uint8_t data, const bool internal);
+    static void writeDivider(const uint8_t data, const bool internal);
+    static void writeTima(const uint8_t data, const bool internal);
+    static void writeTma(const uint8_t data, const bool internal);
+    static void writeTimerControl(const uint8_t data, const bool internal);
+    static void writeIrqFlag(const uint8_t data, const bool internal);
+    static void writeSoundNR11(const uint8_t data, const bool internal);
+    static void writeSoundNR21(const uint8_t data, const bool internal);
+    static void writeSoundNR31(const uint8_t data, const bool internal);
+    static void writeSoundNR41(const uint8_t data, const bool internal);
+    static void writeSoundNR12(const uint8_t data, const bool internal);
+    static void writeSoundNR22(const uint8_t data, const bool internal);
+    static void writeSoundNR30(const uint8_t data, const bool internal);
+    static void writeSoundNR42(const uint8_t data, const bool internal);
+    static void writeSoundNR14(const uint8_t data, const bool internal);
+    static void writeSoundNR24(const uint8_t data, const bool internal);
+    static void writeSoundNR34(const uint8_t data, const bool internal);
+    static void writeSoundNR44(const uint8_t data, const bool internal);
+
     // Video RAM
     // Addr: MEM_VRAM
     static uint8_t vram[0x2000];
@@ -291,3 +403,22 @@ class Memory {
     // Addr: MEM_INT_EN_REG
     static uint8_t iereg;
 };
+
+// CPU accesses are defined here, so the page table lookup is inlined into
+// the instruction fetch
+inline void Memory::writeByte(const uint16_t location, const uint8_t data) {
+    uint8_t* page = writePages[location >> 8];
+    if (page) {
+        page[location & 0xFF] = data;
+    } else {
+        writeHandlers[location >> 8](location, data);
+    }
+}
+
+inline uint8_t Memory::readByte(const uint16_t location) {
+    const uint8_t* page = readPages[location >> 8];
+    if (page) {
+        return page[location & 0xFF];
+    }
+    return readHandlers[location >> 8](location);
+}
@@ -40,14 +40,15 @@
 // PPU TODOs:
 //  Make sure all bits in LCDC are being acted upon
 //      DONE Bit 7: LCD Display Enable
-//      Bit 6: Window tile map display select
-//      Bit 5: Window display enable
-//      Bit 4: BG & Window tile data select
+//      DONE Bit 6: Window tile map display select
+//      DONE Bit 5: Window display enable
+//      DONE Bit 4: BG & Window tile data select
 //      DONE Bit 3: BG Tile Map Display Select
 //      Bit 2: Sprite size
 //      DONE Bit 1: Sprite display enable
 //      Bit 0: BG/Window Display/Priority
-//  Look in to how windows work, implement that behavior
+//  DONE Look in to how windows work, implement that behavior
+//  DONE Lock OAM during mode 2 and OAM and VRAM during mode 3
 //  Implement Background and sprite (OPB0, OBP1) color palettes
 
 #include "PPU.h"
@@ -57,25 +58,77 @@
 #include <string.h>
 
 #include "CPU.h"
+#include "Display.h"
 #include "Memory.h"
+#include "SpriteIndex.h"
+#include "TileCache.h"
 
-#define COLOR1 0x0000
-#define COLOR2 0x4BC4
-#define COLOR3 0x968B
-#define COLOR4 0xFFFF
-
-uint16_t PPU::frames[2][160 * 144] = {{0}, {0}};
-uint64_t PPU::ticks = 0;
+uint64_t PPU::nextTick = PPU_TICKS_TRANSFER;
+uint8_t PPU::lineTicks = PPU_TICKS_TRANSFER;
 uint8_t PPU::originX = 0, PPU::originY = 0, PPU::lcdc = 0, PPU::lcdStatus = 0;
+bool PPU::statLine = false;
+
+const ppu_palette_t PPU::palettes[PPU_PALETTE_COUNT] = {
+    {"Green", {0xFFFF, 0x968B, 0x4BC4, 0x0000}, {0xFFFF, 0x968B, 0x4BC4, 0x0000}, {0xFFFF, 0x968B, 0x4BC4, 0x0000}},
+    {"Gray", {0xFFFF, 0xAD55, 0x52AA, 0x0000}, {0xFFFF, 0xAD55, 0x52AA, 0x0000}, {0xFFFF, 0xAD55, 0x52AA, 0x0000}},
+    // Gray background with red and blue sprites
+    {"Red and blue", {0xFFFF, 0xAD55, 0x52AA, 0x0000}, {0xFFFF, 0xFC10, 0xA800, 0x0000}, {0xFFFF, 0x841F, 0x0015, 0x0000}},
+};
+ppu_palette_t PPU::palette = PPU::palettes[0];
+uint16_t PPU::frameColors[PPU_SLOT_COLORS * PPU_PALETTE_SLOTS] = {0};
+uint8_t PPU::paletteSlot = 0;
+bool PPU::paletteSlotUsed = false;
+uint8_t PPU::bgp = 0, PPU::obp0 = 0, PPU::obp1 = 0;
+bool PPU::colorsValid = false;
+uint8_t PPU::backgroundLine[160] = {0};
+uint8_t PPU::line[160] = {0};
+uint8_t PPU::windowLine = 0;
 
-void PPU::getBackgroundForLine(const uint8_t y, uint16_t *frame, const uint8_t originX, const uint8_t originY) {
-    memset(frame + y * 160, 0x33, sizeof(uint16_t) * 160);
-    uint8_t lcdc = Memory::readByte(MEM_LCDC);
-    uint8_t tileIndex, tileLineU, tileLineL;
-    int8_t signedTileIndex;
+void PPU::setPalette(const uint8_t index) { setPalette(palettes[index < PPU_PALETTE_COUNT ? index : 0]); }
+
+void PPU::setPalette(const ppu_palette_t &palette) {
+    PPU::palette = palette;
+    colorsValid = false;
+}
+
+const ppu_palette_t &PPU::getPalette() { return palette; }
+
+void PPU::updateColors() {
+    const uint8_t newBgp = Memory::readByteInternal(MEM_BGP);
+    const uint8_t newObp0 = Memory::readByteInternal(MEM_OBP0);
+    const uint8_t newObp1 = Memory::readByteInternal(MEM_OBP1);
+    if (colorsValid && newBgp == bgp && newObp0 == obp0 && newObp1 == obp1) {
+        return;
+    }
+    // Lines that have been drawn keep the colors of their slot
+    if (paletteSlotUsed && paletteSlot + 1 < PPU_PALETTE_SLOTS) {
+        paletteSlot++;
+    }
+    paletteSlotUsed = false;
+    // Bits 0-1 of a palette register hold the shade of color number 0,
+    // bits 2-3 the shade of color number 1 and so on
+    uint16_t *colors = frameColors + paletteSlot * PPU_SLOT_COLORS;
+    for (uint8_t color = 0; color < 4; color++) {
+        colors[color] = palette.background[(newBgp >> (color * 2)) & 0x03];
+        colors[4 + color] = palette.object0[(newObp0 >> (color * 2)) & 0x03];
+        colors[8 + color] = palette.object1[(newObp1 >> (color * 2)) & 0x03];
+    }
+    bgp = newBgp;
+    obp0 = newObp0;
+    obp1 = newObp1;
+    colorsValid = true;
+}
+
+void PPU::resetColors() {
+    if (paletteSlot != 0) {
+        memcpy(frameColors, frameColors + paletteSlot * PPU_SLOT_COLORS, PPU_SLOT_COLORS * sizeof(uint16_t));
+        paletteSlot = 0;
+    }
+    paletteSlotUsed = false;
+}
 
-    uint8_t tilePosY = floor(y / 8) * 8;
-    uint8_t tileLineY = y - tilePosY;
+void PPU::getBackgroundForLine(const uint8_t y, uint8_t *line, const uint8_t originX, const uint8_t originY) {
+    uint8_t lcdc = Memory::readByteInternal(MEM_LCDC);
 
     // Check to see which Background Tile Map is selected
     uint16_t bgTileMap = MEM_VRAM_MAP1;
@@ -85,124 +138,219 @@ void PPU::getBackgroundForLine(const uint8_t y, uint16_t *frame, const uint8_t o
         bgTileMap = MEM_VRAM_MAP2;
     }
 
+    // The window covers the line from its left edge to the right end of
+    // the screen. WX holds the left edge plus 7
+    uint8_t windowX = 160;
+    uint8_t windowMapX = 0;
+    // Bit 5 of LCDC enables the window
+    if ((lcdc & 0x20) == 0x20 && y >= Memory::readByteInternal(MEM_WY)) {
+        const uint8_t wx = Memory::readByteInternal(MEM_WX);
+        if (wx < 167) {
+            windowX = wx < 7 ? 0 : wx - 7;
+            windowMapX = windowX + 7 - wx;
+        }
+    }
+
+    // The background and the window share the tile data, so every pixel
+    // of the line is written once from one of them. SCX and SCY move the
+    // screen over the background map, which wraps around at its edges
+    const uint8_t mapY = y + originY;
+    copyTileRow(lcdc, bgTileMap + 32 * (mapY / 8), originX, mapY & 0x07, line, 0, windowX);
+    if (windowX < 160) {
+        // Bit 6 of LCDC selects the Window Tile Map
+        const uint16_t windowTileMap = (lcdc & 0x40) == 0x40 ? MEM_VRAM_MAP2 : MEM_VRAM_MAP1;
+        copyTileRow(lcdc, windowTileMap + 32 * (windowLine / 8), windowMapX, windowLine & 0x07, line, windowX, 160);
+        // The window has its own line counter, it only counts lines the
+        // window has been drawn on
+        windowLine++;
+    }
+}
+
+void PPU::copyTileRow(const uint8_t lcdc, const uint16_t map, uint8_t mapX, const uint8_t tileLineY, uint8_t *line, uint8_t start, const uint8_t end) {
     // Check to see which addressing method is being used for VRAM
-    uint16_t baseTilePtr = MEM_VRAM_TILES_B2;
+    uint16_t baseTile = (MEM_VRAM_TILES_B2 - MEM_VRAM_TILES) / 16;
     bool convertTileIndex = true;
     // If LCDC bit 4 is set, use VRAM Tiles Block0 as a base pointer
     // for the tiles and access them with an unsigned index (0 - 255)
     // Otherwise, use VRAM Tiles Block1 as a base pointer for the
     // tiles and access them with a signed index (-128 to 127)
     if ((lcdc & 0x10) == 0x10) {
-        baseTilePtr = MEM_VRAM_TILES;
+        baseTile = 0;
         convertTileIndex = false;
     }
 
-    for (uint8_t i = 0; i < 20; i++) {
-        tileIndex = Memory::readByte(bgTileMap + i + 32 * (tilePosY / 8));
+    // Get the decoded row of the tile at a pixel of the map row, the row
+    // wraps around after 32 tiles
+    const uint8_t *mapRow = Memory::vram + (map - MEM_VRAM);
+    auto getRow = [&](const uint8_t x) {
+        const uint8_t tileIndex = mapRow[x / 8];
         // Check to see if the tile index needs to be converted to a signed number
-        if (convertTileIndex) {
-            // Convert the tile index and use it
-            signedTileIndex = (int8_t)tileIndex;
-            tileLineL = Memory::readByte(baseTilePtr + signedTileIndex * 16 + tileLineY * 2);
-            tileLineU = Memory::readByte(baseTilePtr + signedTileIndex * 16 + tileLineY * 2 + 1);
-        } else {
-            // Use the tile index as an unsigned number
-            tileLineL = Memory::readByte(baseTilePtr + tileIndex * 16 + tileLineY * 2);
-            tileLineU = Memory::readByte(baseTilePtr + tileIndex * 16 + tileLineY * 2 + 1);
-        }
-        for (int8_t c = 0; c < 8; c++) {
-            frame[y * 160 + i * 8 + c] = (((tileLineU >> (7 - c)) << 1) & 0x2) | ((tileLineL >> (7 - c)) & 0x1);
-        }
+        const uint16_t tile = convertTileIndex ? baseTile + (int8_t)tileIndex : baseTile + tileIndex;
+        return TileCache::getRow(tile, tileLineY);
+    };
+
+    // A tile cut by the start is copied in part
+    const uint8_t skip = mapX & 0x07;
+    if (skip != 0 && start < end) {
+        const uint8_t count = end - start < 8 - skip ? end - start : 8 - skip;
+        memcpy(line + start, getRow(mapX) + skip, count);
+        start += count;
+        mapX += count;
+    }
+    // Copy the whole tiles
+    while (end - start >= 8) {
+        memcpy(line + start, getRow(mapX), 8);
+        start += 8;
+        mapX += 8;
+    }
+    // And the part of the tile before the end
+    if (start < end) {
+        memcpy(line + start, getRow(mapX), end - start);
     }
 }
 
-void PPU::getSpritesForLine(const uint8_t y, uint16_t *frame) {
-    uint8_t spritePosX, spritePosY;
-    uint8_t tileIndex, attributes, tileLineU, tileLineL, pixel;
-    int16_t spriteLineY, x;
-
-    for (uint16_t i = 0xFE00; i < 0xFEA0; i += 4) {
-        spritePosY = Memory::readByte(i) - 16;
-        spriteLineY = y - spritePosY;
-        if (spriteLineY >= 0 && spriteLineY < 8) {
-            spritePosX = Memory::readByte(i + 1) - 8;
-            tileIndex = Memory::readByte(i + 2);
-            attributes = Memory::readByte(i + 3);
-
-            tileLineL = Memory::readByte(MEM_VRAM_TILES + tileIndex * 16 + spriteLineY * 2);
-            tileLineU = Memory::readByte(MEM_VRAM_TILES + tileIndex * 16 + spriteLineY * 2 + 1);
-
-            for (int8_t c = 0; c < 8; c++) {
-                x = spritePosX + c;
-                if (x >= 0) {
-                    if ((attributes & 0x80) == 0 || frame[y * 160 + x] == 0) {
-                        pixel = (((tileLineU >> (7 - c)) << 1) & 0x2) | ((tileLineL >> (7 - c)) & 0x1);
-                        if (pixel != 0) frame[y * 160 + x] = pixel;
-                    }
-                }
+void PPU::getSpritesForLine(const uint8_t y, const uint8_t *background, uint8_t *line) {
+    // Bit 2 of LCDC selects 8x16 sprites
+    const bool tall = (lcdc & 0x04) == 0x04;
+    SpriteIndex::update(tall);
+    const uint8_t count = SpriteIndex::getCount(y);
+    if (count == 0) {
+        return;
+    }
+    const sprite_t *sprites = SpriteIndex::getSprites(y);
+
+    // Pixels already covered by a sprite with a higher priority
+    bool covered[160] = {false};
+
+    for (uint8_t i = 0; i < count; i++) {
+        const sprite_t &sprite = sprites[i];
+        int16_t spriteLineY = y - (sprite.y - 16);
+        // Bit 6 of the attributes flips the sprite vertically, bit 5
+        // horizontally
+        if ((sprite.attributes & 0x40) == 0x40) {
+            spriteLineY = (tall ? 15 : 7) - spriteLineY;
+        }
+        // 8x16 sprites are made of two tiles, the top one is even
+        const uint8_t tile = tall ? (sprite.tile & 0xFE) + (spriteLineY >> 3) : sprite.tile;
+        const uint8_t tileLineY = spriteLineY & 0x07;
+        const uint8_t *row = (sprite.attributes & 0x20) == 0x20 ? TileCache::getFlippedRow(tile, tileLineY) : TileCache::getRow(tile, tileLineY);
+        // Bit 4 of the attributes selects OBP1
+        const uint8_t colors = (sprite.attributes & 0x10) == 0x10 ? 8 : 4;
+
+        const int16_t spritePosX = sprite.x - 8;
+        for (uint8_t c = 0; c < 8; c++) {
+            const int16_t x = spritePosX + c;
+            // Sprites can be partially off screen
+            if (x < 0 || x >= 160 || row[c] == 0 || covered[x]) {
+                continue;
+            }
+            covered[x] = true;
+            // Bit 7 of the attributes hides the sprite behind background
+            // colors 1 - 3
+            if ((sprite.attributes & 0x80) == 0 || background[x] == 0) {
+                line[x] = colors + row[c];
             }
         }
     }
 }
 
-void PPU::mapColorsForFrame(uint16_t *frame) {
-    for (uint16_t i = 0; i < 160 * 144; i++) {
-        frame[i] = (frame[i] == 0x3) ? COLOR1 : ((frame[i] == 0x2) ? COLOR2 : ((frame[i] == 0x1) ? COLOR3 : COLOR4));
+void PPU::packLine(const uint8_t *line, uint8_t *packed) {
+    for (uint8_t x = 0; x < 80; x++) {
+        packed[x] = line[2 * x] | (line[2 * x + 1] << 4);
+    }
+}
+
+uint64_t PPU::hashLine(const uint8_t *packed, const uint8_t slot) {
+    // Multiplicative hash over sixteen pixels at a time, lines drawn with
+    // another slot hash differently
+    uint64_t hash = slot;
+    for (uint8_t x = 0; x < 80; x += 8) {
+        uint64_t pixels;
+        memcpy(&pixels, packed + x, sizeof(pixels));
+        hash = (hash ^ pixels) * 0x9E3779B97F4A7C15ULL;
+    }
+    return hash ^ (hash >> 32);
+}
+
+template <typename Core>
+void PPU::statInterrupt(const uint8_t source) {
+    const uint8_t stat = Memory::readByteInternal(MEM_LCD_STATUS);
+    if (Core::statIrqBlocking) {
+        // All sources share a single interrupt line which only requests
+        // an interrupt when it goes from low to high
+        const uint8_t mode = stat & 0x03;
+        const bool line = ((stat & 0x08) && mode == 0) || ((stat & 0x10) && mode == 1) || ((stat & 0x20) && mode == 2) || ((stat & 0x44) == 0x44);
+        if (line && !statLine) {
+            Memory::interrupt(IRQ_LCD_STAT);
+        }
+        statLine = line;
+    } else if ((stat & source) == source) {
+        Memory::interrupt(IRQ_LCD_STAT);
     }
 }
 
-void PPU::ppuStep(FT81x &ft81x) {
-    uint8_t y = Memory::readByte(MEM_LCD_Y) % 152;
-    static uint8_t sendingFrame = 1;
-    static uint8_t calculatingFrame = 0;
-
-    while (ticks < CPU::totalCycles) {
-        ticks++;
-        const uint8_t cycleTicks = ticks % 114;
-
-        switch (cycleTicks) {
-            case 0:  // reading from OAM memory
-                // TODO: Disable access to OAM during this time
-                lcdStatus = Memory::readByte(MEM_LCD_STATUS);
-                // Set LCD STAT to Mode 2: Searching OAM
-                Memory::writeByteInternal(MEM_LCD_STATUS, (lcdStatus & 0xFC) | 0x02, true);
-                // Trigger an OAM interrupt through LCD STAT if enabled
-                if ((lcdStatus & 0x20) == 0x20) {
-                    Memory::interrupt(IRQ_LCD_STAT);
+template <typename Core>
+void PPU::runModeChanges() {
+    uint8_t y = Memory::readByteInternal(MEM_LCD_Y) % 152;
+
+    while (nextTick <= CPU::totalCycles) {
+        switch (lineTicks) {
+            case PPU_TICKS_OAM:  // reading from OAM memory
+                lcdc = Memory::readByteInternal(MEM_LCDC);
+                // Only visible lines search OAM and transfer data. The line
+                // is counted up at the start of H-Blank
+                if ((lcdc & 0x80) == 0x80 && (y + 1) % 152 < 144) {
+                    if (Core::videoMemoryLocking) {
+                        Memory::lockVideoMemory(true, false);
+                    }
+                    lcdStatus = Memory::readByteInternal(MEM_LCD_STATUS);
+                    // Set LCD STAT to Mode 2: Searching OAM
+                    Memory::writeByteInternal(MEM_LCD_STATUS, (lcdStatus & 0xFC) | 0x02, true);
+                    // Trigger an OAM interrupt through LCD STAT if enabled
+                    statInterrupt<Core>(0x20);
                 }
                 break;
 
-            case 20:  // reading from both OAM and VRAM
-                // TODO: Disable access to all video memory during this time
-                lcdStatus = Memory::readByte(MEM_LCD_STATUS);
-                // Set LCD STAT to mode 0x3, Transfer Data to LCD Driver
-                Memory::writeByteInternal(MEM_LCD_STATUS, (lcdStatus & 0xFC) | 0x03,
-                                          true);  // BUG: Shouldn't this be 0x03? If things break, return 0x03 to 0x02
+            case PPU_TICKS_TRANSFER:  // reading from both OAM and VRAM
+                lcdStatus = Memory::readByteInternal(MEM_LCD_STATUS);
+                if ((lcdc & 0x80) == 0x80 && (y + 1) % 152 < 144) {
+                    if (Core::videoMemoryLocking) {
+                        Memory::lockVideoMemory(true, true);
+                    }
+                    // Set LCD STAT to mode 0x3, Transfer Data to LCD Driver
+                    lcdStatus = (lcdStatus & 0xFC) | 0x03;
+                }
                 // Check if we the current line is the same as what's in LY Compare (LYC)
-                if (y == Memory::readByte(MEM_LCD_YC)) {
+                if (y == Memory::readByteInternal(MEM_LCD_YC)) {
                     // Set coincidence flag
                     Memory::writeByteInternal(MEM_LCD_STATUS, (lcdStatus & 0xFB) | 0x04, true);
                     // Trigger coincidence interrupt through LCD STAT if enabled
-                    if ((lcdStatus & 0x40) == 0x40) {
-                        Memory::interrupt(IRQ_LCD_STAT);
-                    }
+                    statInterrupt<Core>(0x40);
                 } else {
                     // Otherwise, clear the coincidence flag
                     Memory::writeByteInternal(MEM_LCD_STATUS, (lcdStatus & 0xFB) | 0x00, true);
+                    if (Core::statIrqBlocking) {
+                        statInterrupt<Core>(0x40);
+                    }
                 }
                 break;
 
-            case 43:  // H-Blank and V-Blank period
-                lcdc = Memory::readByte(MEM_LCDC);
-                lcdStatus = Memory::readByte(MEM_LCD_STATUS);
+            case PPU_TICKS_HBLANK:  // H-Blank and V-Blank period
+                // Video memory is accessible again in H-Blank and V-Blank
+                // or when the LCD is disabled
+                if (Core::videoMemoryLocking) {
+                    Memory::lockVideoMemory(false, false);
+                }
+                lcdc = Memory::readByteInternal(MEM_LCDC);
+                lcdStatus = Memory::readByteInternal(MEM_LCD_STATUS);
                 // Check if LCD is enabled
                 if ((lcdc & 0x80) == 0x80) {
                     y = (y + 1) % 152;
                     // Update the current LCD Y coordinate
-                    Memory::writeByte(MEM_LCD_Y, y);
+                    Memory::writeByteInternal(MEM_LCD_Y, y, true);
                     // Get the X and Y posision of the background map
-                    originY = Memory::readByte(MEM_LCD_SCROLL_Y);
-                    originX = Memory::readByte(MEM_LCD_SCROLL_X);
+                    originY = Memory::readByteInternal(MEM_LCD_SCROLL_Y);
+                    originX = Memory::readByteInternal(MEM_LCD_SCROLL_X);
                     // Make sure we're in the visible portion of the screen
                     if (y < 144) {
                         // Because of how our screen works in the emulator, we
@@ -214,37 +362,58 @@ void PPU::ppuStep(FT81x &ft81x) {
                         // This will need to be rewritten if we ever need to
                         // emulate some behavior that takes place mid-scanline
 
+                        // The line is drawn with the colors of the current
+                        // palette registers
+                        if (y == 0) {
+                            resetColors();
+                            windowLine = 0;
+                        }
+                        updateColors();
                         // Check if background is enabled
                         if ((lcdc & 0x01) == 0x01) {
                             // Get the background for the current line
-                            getBackgroundForLine(y, frames[calculatingFrame], originX, originY);
+                            getBackgroundForLine(y, backgroundLine, originX, originY);
+                        } else {
+                            // Otherwise the background is blank
+                            memset(backgroundLine, 0, sizeof(backgroundLine));
                         }
+                        // Background color numbers are the first entries
+                        // of the palette slot
+                        memcpy(line, backgroundLine, sizeof(line));
                         // Check if sprites are enabled
                         if ((lcdc & 0x02) == 0x02) {
                             // Get the sprite for the current line
-                            getSpritesForLine(y, frames[calculatingFrame]);
+                            getSpritesForLine(y, backgroundLine, line);
                         }
+                        paletteSlotUsed = true;
+                        // The frame keeps the line packed with its slot
+                        display_frame_t *frame = Display::getDrawingFrame();
+                        uint8_t *packed = frame->pixels + y * 80;
+                        packLine(line, packed);
+                        frame->lineSlots[y] = paletteSlot;
+                        frame->lineHashes[y] = hashLine(packed, paletteSlot);
                         // Set LCD STAT to mode 0, During H-Blank
                         Memory::writeByteInternal(MEM_LCD_STATUS, (lcdStatus & 0xFC) | 0x00, true);
                         // Trigger H-Blank interrupt through LCD STAT if enabled
-                        if ((lcdStatus & 0x08) == 0x08) {
-                            Memory::interrupt(IRQ_LCD_STAT);
-                        }
+                        statInterrupt<Core>(0x08);
                         // If we're outside viewable area, we're in VBLANK
                     } else if (y == 144) {
                         // Set LCD STAT to mode 1, VBlank
                         Memory::writeByteInternal(MEM_LCD_STATUS, (lcdStatus & 0xFC) | 0x01, true);
                         // Trigger a VBLANK interrupt
                         Memory::interrupt(IRQ_VBLANK);
+                        // The STAT V-Blank interrupt is only emulated by
+                        // the accurate core
+                        if (Core::statIrqBlocking) {
+                            statInterrupt<Core>(0x10);
+                        }
 
-                        // Map colors for the frame
-                        mapColorsForFrame(frames[calculatingFrame]);
-
-                        // Swap the sending and calculating frame
-                        sendingFrame = calculatingFrame;
-                        calculatingFrame = !calculatingFrame;
-                        // Write the sending frame to the screen
-                        ft81x.writeGRAM(0, 2 * 160 * 144, (uint8_t *)frames[sendingFrame]);
+                        // Hand the frame and its colors to the display, it
+                        // is sent in the background
+                        display_frame_t *frame = Display::getDrawingFrame();
+                        frame->slots = paletteSlot + 1;
+                        memcpy(frame->colors, frameColors, frame->slots * PPU_SLOT_COLORS * sizeof(uint16_t));
+                        Display::presentFrame();
                     }
                 } else {
                     // If LCD is not enabled, always set LCD STAT to mode 1, Vertical Blanking
@@ -255,5 +424,13 @@ void PPU::ppuStep(FT81x &ft81x) {
             default:
                 break;
         }
+
+        // Jump to the next mode change
+        const uint8_t next = lineTicks == PPU_TICKS_OAM ? PPU_TICKS_TRANSFER : lineTicks == PPU_TICKS_TRANSFER ? PPU_TICKS_HBLANK : PPU_TICKS_LINE;
+        nextTick += next - lineTicks;
+        lineTicks = next % PPU_TICKS_LINE;
     }
 }
+
+template void PPU::runModeChanges<FastCore>();
+template void PPU::runModeChanges<AccurateCore>();
@@ -18,25 +18,115 @@
 
 #pragma once
 
+#include <Accuracy.h>
 #include <Arduino.h>
+#include <CPU.h>
 #include <FT81x.h>
 #include <Memory.h>
 
+// Amount of built in palettes
+#define PPU_PALETTE_COUNT 3
+
+// Colors of the four shades of gray of every layer, lightest first, as
+// RGB565. BGP, OBP0 and OBP1 pick from these
+typedef struct {
+    const char *name;
+    uint16_t background[4];
+    uint16_t object0[4];
+    uint16_t object1[4];
+} ppu_palette_t;
+
+// Locations of the frame, a palette index per pixel, and its palette of
+// RGB565 colors in the graphics RAM
+#define PPU_FRAME_OFFSET   0
+#define PPU_PALETTE_OFFSET (160 * 144)
+
+// Every set of palette registers used in a frame gets a slot of 12
+// palette entries: 4 background colors, then 4 colors each of OBP0 and
+// OBP1. Frames that change the palette registers more often than there
+// are slots reuse the last one
+#define PPU_SLOT_COLORS   12
+#define PPU_PALETTE_SLOTS 21
+
+// Cycles into a line at which the PPU changes mode, a line takes 114
+#define PPU_TICKS_OAM      0
+#define PPU_TICKS_TRANSFER 20
+#define PPU_TICKS_HBLANK   43
+#define PPU_TICKS_LINE     114
+
 class PPU {
    public:
-    static void ppuStep(FT81x &ft81x);
+    // Nothing happens between the mode changes of a line, so the PPU only
+    // runs when the next one is due. This is checked after every instruction
+    template <typename Core>
+    static inline void ppuStep() {
+        if (nextTick <= CPU::totalCycles) {
+            runModeChanges<Core>();
+        }
+    }
+
+    // Select one of the built in palettes, 0 is the default green
+    static void setPalette(const uint8_t index);
+    // Use the colors of a user defined palette
+    static void setPalette(const ppu_palette_t &palette);
+    // Get the palette that is in use
+    static const ppu_palette_t &getPalette();
 
    protected:
     // Handle to Memory
     static Memory *mem;
-    static uint16_t frames[2][160 * 144];
-    static uint64_t ticks;
+    // Cycle of the next mode change and where it is in its line
+    static uint64_t nextTick;
+    static uint8_t lineTicks;
+
+    // Run all mode changes up to the current cycle
+    template <typename Core>
+    static void runModeChanges();
     static uint8_t originX, originY, lcdc, lcdStatus;
+    // State of the combined LCD STAT interrupt line
+    static bool statLine;
+
+    // Request an LCD STAT interrupt if the given STAT source is enabled
+    template <typename Core>
+    static void statInterrupt(const uint8_t source);
+
+    static const ppu_palette_t palettes[PPU_PALETTE_COUNT];
+    static ppu_palette_t palette;
+    // Final colors of the palette slots of the frame being drawn, built
+    // from the palette registers
+    static uint16_t frameColors[PPU_SLOT_COLORS * PPU_PALETTE_SLOTS];
+    // Slot the current line is drawn with and if a line already uses it
+    static uint8_t paletteSlot;
+    static bool paletteSlotUsed;
+    // Values of BGP, OBP0 and OBP1 the colors of the slot were built for
+    static uint8_t bgp, obp0, obp1;
+    static bool colorsValid;
+    // Color numbers of the background of the current line, sprites need
+    // them for their priority
+    static uint8_t backgroundLine[160];
+    // Entries in the palette slot of the pixels of the current line
+    static uint8_t line[160];
+    // Line of the window that is drawn next, it only counts up on lines
+    // that show the window
+    static uint8_t windowLine;
+
+    // Build the colors in a new slot if a palette register has changed
+    static void updateColors();
+    // Start the next frame with the colors of the last slot in use
+    static void resetColors();
+
+    // Pack the entries of a line into two pixels per byte
+    static void packLine(const uint8_t *line, uint8_t *packed);
+    // Hash of a packed line, the display only gets the lines that have
+    // changed
+    static uint64_t hashLine(const uint8_t *packed, const uint8_t slot);
 
-    static void getBackgroundForLine(const uint8_t y, uint16_t *frame, const uint8_t originX, const uint8_t originY);
-    static void getSpritesForLine(const uint8_t y, uint16_t *frame);
-    static void getWindowForLine(const uint8_t y, uint16_t *frame);
-    static void mapColorsForFrame(uint16_t *frame);
+    // Get the color numbers of the background and the window of a line
+    static void getBackgroundForLine(const uint8_t y, uint8_t *line, const uint8_t originX, const uint8_t originY);
+    // Copy the decoded tiles of a row of a tile map to the pixels from
+    // start to end of the line, beginning at pixel mapX of the row
+    static void copyTileRow(const uint8_t lcdc, const uint16_t map, uint8_t mapX, const uint8_t tileLineY, uint8_t *line, uint8_t start, const uint8_t end);
+    static void getSpritesForLine(const uint8_t y, const uint8_t *background, uint8_t *line);
 
    private:
 };
@@ -0,0 +1,62 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include "SpriteIndex.h"
+
+#include <string.h>
+
+sprite_t SpriteIndex::lines[144][SPRITES_PER_LINE];
+uint8_t SpriteIndex::counts[144] = {0};
+bool SpriteIndex::dirty = true;
+bool SpriteIndex::tallSprites = false;
+uint32_t SpriteIndex::builds = 0;
+
+void SpriteIndex::build(const bool tall) {
+    const uint8_t height = tall ? 16 : 8;
+    memset(counts, 0, sizeof(counts));
+
+    // Walk OAM in order, so every line keeps the first sprites that cover it
+    const sprite_t *sprites = (const sprite_t *)Memory::oam;
+    for (uint8_t i = 0; i < 40; i++) {
+        const sprite_t &sprite = sprites[i];
+        // Sprites start up to 16 lines above the screen
+        const int16_t top = sprite.y - 16;
+        const int16_t first = top < 0 ? 0 : top;
+        const int16_t last = top + height > 144 ? 144 : top + height;
+        for (int16_t y = first; y < last; y++) {
+            if (counts[y] == SPRITES_PER_LINE) {
+                continue;
+            }
+            // Insert behind all sprites with a smaller or equal X coordinate
+            sprite_t *line = lines[y];
+            uint8_t position = counts[y];
+            while (position > 0 && line[position - 1].x > sprite.x) {
+                line[position] = line[position - 1];
+                position--;
+            }
+            line[position] = sprite;
+            counts[y]++;
+        }
+    }
+
+    tallSprites = tall;
+    dirty = false;
+    builds++;
+}
+
+void SpriteIndex::printStats() { Serial.printf("Sprite index: %u builds, %u bytes\n", builds, (uint32_t)(sizeof(lines) + sizeof(counts))); }
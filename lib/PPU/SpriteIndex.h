@@ -0,0 +1,81 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#pragma once
+
+#include <Arduino.h>
+#include <Memory.h>
+
+// The PPU only draws this many sprites on a line
+#define SPRITES_PER_LINE 10
+
+// A sprite as it is stored in OAM
+typedef struct {
+    // Position on screen + 16
+    uint8_t y;
+    // Position on screen + 8
+    uint8_t x;
+    uint8_t tile;
+    // Bit 7: Behind background colors 1 - 3
+    // Bit 6: Vertical flip
+    // Bit 5: Horizontal flip
+    // Bit 4: Palette (0=OBP0, 1=OBP1)
+    uint8_t attributes;
+} sprite_t;
+
+/**
+ * Index of the sprites on every visible line
+ *
+ * The index is rebuilt from OAM before the next line is drawn once OAM
+ * has been written, an OAM DMA transfer has completed or the sprite
+ * size has changed. Every line lists the first 10 sprites in OAM that
+ * cover it, like the OAM search of the PPU, sorted by drawing priority.
+ * The sprite with the smallest X coordinate comes first, sprites at the
+ * same X coordinate are in OAM order
+ */
+class SpriteIndex {
+   public:
+    // Mark the index outdated after a change to OAM
+    static inline void invalidate() { dirty = true; }
+
+    // Rebuild the index if it is outdated
+    // tall is set for 8x16 sprites, bit 2 of LCDC
+    static inline void update(const bool tall) {
+        if (dirty || tall != tallSprites) {
+            build(tall);
+        }
+    }
+
+    // Get the number of sprites on a line
+    static inline uint8_t getCount(const uint8_t y) { return counts[y]; }
+
+    // Get the sprites on a line in drawing priority order, highest first
+    static inline const sprite_t *getSprites(const uint8_t y) { return lines[y]; }
+
+    static void printStats();
+
+   private:
+    static sprite_t lines[144][SPRITES_PER_LINE];
+    static uint8_t counts[144];
+    static bool dirty;
+    static bool tallSprites;
+
+    static uint32_t builds;
+
+    static void build(const bool tall);
+};
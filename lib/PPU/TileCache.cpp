@@ -0,0 +1,64 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#include "TileCache.h"
+
+#include <string.h>
+
+uint8_t TileCache::rows[TILE_COUNT][8][8] = {{{0}}};
+uint8_t TileCache::flippedRows[TILE_COUNT][8][8] = {{{0}}};
+// VRAM starts out cleared, which is what the cleared rows hold
+uint8_t TileCache::dirtyRows[TILE_COUNT] = {0};
+uint32_t TileCache::decodedRows = 0;
+uint64_t TileCache::spreadTable[256] = {0};
+
+void TileCache::begin() {
+    for (uint16_t bits = 0; bits < 256; bits++) {
+        uint8_t spread[8];
+        for (uint8_t c = 0; c < 8; c++) {
+            spread[c] = (bits >> (7 - c)) & 0x01;
+        }
+        memcpy(&spreadTable[bits], spread, sizeof(spread));
+    }
+    invalidateAll();
+}
+
+void TileCache::invalidateAll() { memset(dirtyRows, 0xFF, sizeof(dirtyRows)); }
+
+void TileCache::decodeTile(const uint16_t tile) {
+    const uint8_t *data = Memory::vram + tile * 16;
+    const uint8_t dirty = dirtyRows[tile];
+    dirtyRows[tile] = 0;
+    for (uint8_t row = 0; row < 8; row++) {
+        if ((dirty & (1 << row)) == 0) {
+            continue;
+        }
+        // The first byte holds the low bits of the row, the second byte the
+        // high bits. The leftmost pixel is bit 7
+        const uint64_t pixels = spreadTable[data[row * 2]] | (spreadTable[data[row * 2 + 1]] << 1);
+        memcpy(rows[tile][row], &pixels, sizeof(pixels));
+        // Mirrored rows are the same pixels in reverse byte order
+        const uint64_t flipped = __builtin_bswap64(pixels);
+        memcpy(flippedRows[tile][row], &flipped, sizeof(flipped));
+        decodedRows++;
+    }
+}
+
+void TileCache::printStats() {
+    Serial.printf("Tile cache: %u rows decoded, %u bytes\n", decodedRows, (uint32_t)(sizeof(rows) + sizeof(flippedRows) + sizeof(dirtyRows)));
+}
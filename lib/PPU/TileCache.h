@@ -0,0 +1,85 @@
+/**
+ * gb.teensy Emulation Software
+ * Copyright (C) 2020  Raphael Stäbler, Grant Haack
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **/
+
+#pragma once
+
+#include <Arduino.h>
+#include <Memory.h>
+
+// Number of tiles in the tile data area of VRAM, 0x8000 - 0x97FF
+#define TILE_COUNT 384
+
+/**
+ * Cache of the VRAM tiles decoded to one byte per pixel
+ *
+ * Every tile row is kept as 8 color numbers, left to right, and mirrored
+ * for horizontally flipped sprites. Writes to the tile data mark the
+ * written row as dirty, it is decoded again the next time it is drawn.
+ * The PPU copies rows out of the cache instead of decoding the bitplanes
+ * of every pixel on every line
+ */
+class TileCache {
+   public:
+    // Mark the row of a tile written at the given location as dirty
+    static inline void invalidate(const uint16_t location) {
+        const uint16_t offset = location - MEM_VRAM_TILES;
+        dirtyRows[offset >> 4] |= 1 << ((offset >> 1) & 0x07);
+    }
+
+    // Build the decode table and mark all tiles dirty
+    static void begin();
+
+    // Mark all tiles dirty, after VRAM was changed without invalidate
+    static void invalidateAll();
+
+    // Get the 8 decoded pixels of a row of a tile
+    // The tile is indexed from 0x8000, so it's 0 - 383
+    static inline const uint8_t *getRow(const uint16_t tile, const uint8_t row) {
+        if (dirtyRows[tile] != 0) {
+            decodeTile(tile);
+        }
+        return rows[tile][row];
+    }
+
+    // Get the 8 decoded pixels of a row of a tile, right to left
+    static inline const uint8_t *getFlippedRow(const uint16_t tile, const uint8_t row) {
+        if (dirtyRows[tile] != 0) {
+            decodeTile(tile);
+        }
+        return flippedRows[tile][row];
+    }
+
+    static void printStats();
+
+   private:
+    // Decoded rows of all tiles, and the same rows mirrored
+    static uint8_t rows[TILE_COUNT][8][8];
+    static uint8_t flippedRows[TILE_COUNT][8][8];
+    // One bit per row of every tile that has to be decoded again
+    static uint8_t dirtyRows[TILE_COUNT];
+
+    static uint32_t decodedRows;
+
+    // The bits of a byte spread out to one byte per bit, bit 7 in the first
+    // byte in memory. A tile row is decoded with two lookups, the spread
+    // upper bitplane shifted by one and or'ed with the spread lower one
+    static uint64_t spreadTable[256];
+
+    // Decode the dirty rows of a tile
+    static void decodeTile(const uint16_t tile);
+};
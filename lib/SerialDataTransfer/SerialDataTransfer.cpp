@@ -21,9 +21,9 @@
 #include "Memory.h"
 
 void SerialDataTransfer::serialStep() {
-    const uint8_t sc = Memory::readByte(MEM_SERIAL_SC);
+    const uint8_t sc = Memory::readByteInternal(MEM_SERIAL_SC);
     if ((sc & 0x81) == 0x81) {
-        Serial.print((char)Memory::readByte(MEM_SERIAL_SB));
+        Serial.print((char)Memory::readByteInternal(MEM_SERIAL_SB));
         Memory::writeByteInternal(MEM_SERIAL_SC, sc & 0x7F, true);
     }
 }
@@ -25,17 +25,31 @@
 #include <Arduino.h>
 #include <CPU.h>
 #include <Cartridge.h>
+#include <Display.h>
 #include <FT81x.h>
 #include <Joypad.h>
 #include <Memory.h>
 #include <PPU.h>
+#include <RomCatalog.h>
+#include <SD.h>
 #include <SerialDataTransfer.h>
 
+// Chip select of the FT81x
+#define DISPLAY_CS_PIN 10
+
+// ROMs per page of the selection menu
+#define ROM_MENU_LINES 19
+// Time between two steps when a direction is held down in ms
+#define ROM_MENU_REPEAT_DELAY 150
+
 void waitForKeyPress();
+uint16_t selectRom();
 
-FT81x ft81x = FT81x(10, 9, 8);
+FT81x ft81x = FT81x(DISPLAY_CS_PIN, 9, 8);
 
 static char title[17];  // 16 chars for name, 1 for null terminator
+// Shown below the ROM list, e.g. why the last ROM couldn't be started
+static char menuMessage[64] = "";
 
 void setup() {
     Serial.begin(115200);
@@ -46,35 +60,59 @@ void setup() {
 
     Serial.println("Enable display");
     ft81x.begin();
+    Joypad::begin();
 
-    Serial.printf("\nStart Gameboy...\n");
+    // The SD card is initialized once for the catalog and the cartridge
+    Serial.println("Initializing SD card...");
+    if (SD.begin(BUILTIN_SDCARD)) {
+        RomCatalog::begin();
+    } else {
+        Serial.println("SD Card failed, or not present");
+    }
+
+    // Pick the ROM from the catalog of the SD card, until one can be
+    // started
+    char romFile[ROM_CATALOG_NAME_SIZE * 2];
+    uint32_t bootStart;
+    while (true) {
+        RomCatalog::getPath(selectRom(), romFile, sizeof(romFile));
 
-    Cartridge::begin("tim10dt.gb");
+        bootStart = micros();
+        Serial.printf("\nStart Gameboy...\n");
+        if (Cartridge::begin(romFile) == 0) {
+            break;
+        }
+        snprintf(menuMessage, sizeof(menuMessage), "Could not start %s", romFile);
+        Serial.println(menuMessage);
+    }
     Cartridge::getGameName(title);
 
-    Memory::initMemory();
+    Memory::initMemory<FastCore>();
     CPU::cpuEnabled = 1;
+    Serial.printf("Time to first instruction: %lu ms\n", (micros() - bootStart) / 1000);
 
+    // Frames are sent by DMA from here on
+    Display::begin(ft81x, DISPLAY_CS_PIN);
+    Display::lockBus();
     ft81x.beginDisplayList();
     ft81x.clear(FT81x_COLOR_RGB(0, 0, 0));
     ft81x.drawText(10, 460, 16, FT81x_COLOR_RGB(255, 0, 255), 0, title);
     ft81x.drawText(470, 460, 16, FT81x_COLOR_RGB(255, 0, 255), FT81x_OPT_RIGHTX, "Emulated speed: ...\0");
-    ft81x.drawBitmap(0, 0, 0, 160, 144, 3);
-    ft81x.swapScreen();
-
+    Display::swapScreen();
+    Display::unlockBus();
     APU::begin();
-    Joypad::begin();
 }
 
 void loop() {
     uint64_t start = millis();
 
     while (true) {
-        CPU::cpuStep();
-        PPU::ppuStep(ft81x);
+        CPU::cpuStep<FastCore>();
+        PPU::ppuStep<FastCore>();
         APU::apuStep();
         SerialDataTransfer::serialStep();
         Joypad::joypadStep();
+        Cartridge::saveStep();
 
         if ((CPU::totalCycles % 1000000) == 0) {
             uint64_t time = millis() - start;
@@ -82,16 +120,77 @@ void loop() {
             uint8_t speed = hz / 10000;
             char buff[21];
             sprintf(buff, "Emulated speed: %d%%", speed);
+            // The display list can't change while a frame is sent
+            Display::lockBus();
             ft81x.beginDisplayList();
             ft81x.clear(FT81x_COLOR_RGB(0, 0, 0));
             ft81x.drawText(10, 460, 16, FT81x_COLOR_RGB(255, 0, 255), 0, title);
             ft81x.drawText(470, 460, 16, FT81x_COLOR_RGB(255, 0, 255), FT81x_OPT_RIGHTX, buff);
-            ft81x.drawBitmap(0, 0, 0, 160, 144, 3);
-            ft81x.swapScreen();
+            Display::swapScreen();
+            Display::unlockBus();
         }
     }
 }
 
+uint16_t selectRom() {
+    const uint16_t count = RomCatalog::getCount();
+    if (count == 0) {
+        ft81x.beginDisplayList();
+        ft81x.clear(FT81x_COLOR_RGB(0, 0, 0));
+        ft81x.drawText(10, 10, 16, FT81x_COLOR_RGB(255, 0, 255), 0, "No ROMs found on the SD card");
+        ft81x.swapScreen();
+        while (true) {
+        }
+    }
+
+    uint16_t selected = 0;
+    uint8_t palette = 0;
+    while (true) {
+        // Show the page of the list with the selected ROM
+        const uint16_t first = selected - selected % ROM_MENU_LINES;
+        ft81x.beginDisplayList();
+        ft81x.clear(FT81x_COLOR_RGB(0, 0, 0));
+        for (uint16_t i = first; i < count && i < first + ROM_MENU_LINES; i++) {
+            const rom_catalog_entry_t *entry = RomCatalog::getEntry(i);
+            const uint32_t color = i == selected ? FT81x_COLOR_RGB(255, 0, 255) : FT81x_COLOR_RGB(255, 255, 255);
+            const uint16_t y = 10 + (i - first) * 22;
+            ft81x.drawText(10, y, 16, color, 0, entry->title[0] ? entry->title : entry->file);
+            ft81x.drawText(790, y, 16, color, FT81x_OPT_RIGHTX, lookupCartType(entry->cartCode));
+        }
+        char paletteText[48];
+        snprintf(paletteText, sizeof(paletteText), "Palette: %s (Select to change)", PPU::getPalette().name);
+        ft81x.drawText(10, 460, 16, FT81x_COLOR_RGB(255, 0, 255), 0, paletteText);
+        ft81x.drawText(10, 438, 16, FT81x_COLOR_RGB(255, 0, 0), 0, menuMessage);
+        ft81x.swapScreen();
+
+        // Wait for a button, all of them are active low
+        while (true) {
+            if (!digitalReadFast(JOYPAD_DOWN)) {
+                selected = (selected + 1) % count;
+                break;
+            }
+            if (!digitalReadFast(JOYPAD_UP)) {
+                selected = (selected + count - 1) % count;
+                break;
+            }
+            if (!digitalReadFast(JOYPAD_SELECT)) {
+                palette = (palette + 1) % PPU_PALETTE_COUNT;
+                PPU::setPalette(palette);
+                while (!digitalReadFast(JOYPAD_SELECT)) {
+                }
+                break;
+            }
+            if (!digitalReadFast(JOYPAD_A) || !digitalReadFast(JOYPAD_START)) {
+                // Don't pass the press on to the game
+                while (!digitalReadFast(JOYPAD_A) || !digitalReadFast(JOYPAD_START)) {
+                }
+                return selected;
+            }
+        }
+        delay(ROM_MENU_REPEAT_DELAY);
+    }
+}
+
 void waitForKeyPress() {
     Serial.println("\nPress a key to continue\n");
     while (!Serial.available()) {
@@ -112,38 +211,249 @@ void waitForKeyPress() {
 // > .pio/build/native/program 0 70000000
 //
 // The commands above will run the ROM data at ROM::getRom(0) for 70000000 cycles.
+// Instead of a ROM index, the path of a ROM file on the mocked SD card can be given.
+// The file is mapped into memory and run from there, e.g.
+// > .pio/build/native/program tetris.gb 70000000 --sd-dir=roms
 // All the Serial output is printed to stdout.
+//
+// Options:
+//   --core=<tier>          Accuracy tier to run: accurate (default), fast or both
+//                          "both" runs each tier from a clean state and compares their speed
+//   --break=<addr>         Stop before executing the instruction at addr (hex)
+//   --watch=<addr>[:r|w]   Stop on reads and/or writes of addr (hex), e.g. --watch=ff40:w
+//   --sd-dir=<dir>         Host directory that backs the mocked SD card (default: working directory)
+//   --sd                   Load the ROM through the SD card code path and page its banks in from there.
+//                          Built in ROMs are stored on the mocked SD card first
+//   --rom-frames=<n>       Amount of ROM bank frames used with --sd
+//   --palette=<n>          Built in palette the frames are drawn with, 0 (default) to 2
+//   --spi-delay            Let display transfers take as long as they would over SPI, to see
+//                          how many frames the display can't keep up with
+//   --catalog              Build the ROM catalog of the mocked SD card, print it and run the ROM with
+//                          the given index in it, e.g. program 2 70000000 --catalog --sd-dir=roms
+//
+// The RAM of battery backed cartridges is kept in a save file next to the ROM file, e.g. roms/tetris.sav
+// After the run, the emulated speed and cartridge statistics are printed for benchmarking.
 
 #include <Arduino.h>
 #include <CPU.h>
+#include <Cartridge.h>
+#include <Debugger.h>
+#include <Display.h>
 #include <Memory.h>
 #include <PPU.h>
+#include <RomCatalog.h>
 #include <SD.h>
 #include <SerialDataTransfer.h>
+#include <SpriteIndex.h>
+#include <TileCache.h>
 #include <rom.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 SDClass SD;
 StdioSerial Serial;
 FT81x ft81x = FT81x(10, 9, 8);
 
+// File the ROM is stored in on the mocked SD card
+#define SD_ROM_FILE "rom.gb"
+
+static bool useSd = false;
+static bool useCatalog = false;
+static uint8_t romFrames = ROM_BANK_FRAMES;
+// ROM file on the mocked SD card, 0 to use a built in ROM
+static const char *romPath = 0;
+static File romImage;
+
+// Load the ROM data into the cartridge, either directly or through the mocked SD card
+bool loadCartridge(const unsigned int romIndex) {
+    if (romPath == 0) {
+        const uint8_t *data = ROM::getRom(romIndex);
+        if (!useSd) {
+            return Cartridge::begin(data) == 0;
+        }
+        File file = SD.open(SD_ROM_FILE, FILE_WRITE);
+        file.seek(0);
+        file.write(data, lookupRomSize(data[ROM_CODE]));
+        file.close();
+        return Cartridge::begin(SD_ROM_FILE, romFrames) == 0;
+    }
+
+    // Compressed ROMs are decompressed through the SD card code path
+    romImage = SD.open(romPath);
+    if (useSd || (romImage.size() >= CART_HEADER_SIZE && RomContainer::isContainer(romImage.data()))) {
+        romImage.close();
+        return Cartridge::begin(romPath, romFrames) == 0;
+    }
+    // Run the ROM straight from the mapped file
+    if (romImage.size() < CART_HEADER_SIZE || romImage.size() < lookupRomSize(romImage.data()[ROM_CODE])) {
+        printf("Could not load ROM file %s\n", romPath);
+        return false;
+    }
+    return Cartridge::begin(romImage.data(), romPath) == 0;
+}
+
+void breakAndExit(const uint8_t reason, const uint16_t location, const uint8_t data) {
+    if (reason == BREAK_EXEC) {
+        printf("\nBreakpoint at %04x\n", location);
+    } else {
+        printf("\nWatchpoint: %s %02x at %04x\n", reason == BREAK_READ ? "read" : "write", data, location);
+    }
+    printf("Cycles: %llu\n", (unsigned long long)CPU::totalCycles);
+    CPU::dumpRegister();
+    // The sender thread has to be stopped before the process can exit
+    Display::end();
+    exit(0);
+}
+
+// Run the ROM on the given accuracy tier and return the time it took in us
+template <typename Core>
+unsigned long run(const unsigned int romIndex, const unsigned long cycleCount) {
+    const unsigned long bootStart = micros();
+    if (!loadCartridge(romIndex)) {
+        exit(1);
+    }
+    Memory::initMemory<Core>();
+    CPU::cpuEnabled = 1;
+
+    Display::begin(ft81x, 0);
+    Display::lockBus();
+    ft81x.beginDisplayList();
+    ft81x.clear(FT81x_COLOR_RGB(0, 0, 0));
+    Display::swapScreen();
+    Display::unlockBus();
+    const unsigned long start = micros();
+    printf("Time to first instruction: %lu us\n", start - bootStart);
+
+    while (CPU::totalCycles < cycleCount) {
+        CPU::cpuStep<Core>();
+        PPU::ppuStep<Core>();
+        SerialDataTransfer::serialStep();
+        Cartridge::saveStep();
+    }
+
+    const unsigned long time = micros() - start;
+    // Send the last frame
+    Display::end();
+    printf("\nEmulated %llu cycles in %lu ms on the %s core (%llu%% speed)\n", (unsigned long long)CPU::totalCycles, time / 1000, Core::name(),
+           (unsigned long long)CPU::totalCycles * 100000000ULL / 1048576 / (time + 1));
+    Cartridge::printStats();
+    TileCache::printStats();
+    SpriteIndex::printStats();
+    Display::printStats();
+    printf("Display transfers: %u writes, %llu bytes, %u display list swaps\n", ft81x.gramWrites, (unsigned long long)ft81x.gramBytes, ft81x.displayListSwaps);
+    // Write back the save RAM
+    Cartridge::end();
+    return time;
+}
+
+// Run the ROM in a child process, so every tier starts from a clean state
+template <typename Core>
+unsigned long runForked(const unsigned int romIndex, const unsigned long cycleCount) {
+    int result[2];
+    unsigned long time = 0;
+    if (pipe(result) != 0) {
+        return 0;
+    }
+    fflush(stdout);
+    if (fork() == 0) {
+        time = run<Core>(romIndex, cycleCount);
+        fflush(stdout);
+        write(result[1], &time, sizeof(time));
+        _exit(0);
+    }
+    read(result[0], &time, sizeof(time));
+    wait(NULL);
+    close(result[0]);
+    close(result[1]);
+    return time;
+}
+
 int main(int argc, char **argv) {
-    if (argc != 3) {
+    if (argc < 3) {
         printf("Invalid argument count %i instead of 3.\n", argc);
-        printf("Usage: program [rom index] [cycle count]\n");
+        printf("Usage: program [rom index|rom file] [cycle count] [options]\n");
         return 1;
     }
 
-    const unsigned int romIndex = atoi(argv[1]);
+    char *indexEnd;
+    const unsigned int romIndex = strtoul(argv[1], &indexEnd, 10);
+    if (*indexEnd != 0) {
+        romPath = argv[1];
+    }
     const unsigned long cycleCount = atol(argv[2]);
+    const char *core = "accurate";
 
-    Cartridge::begin(ROM::getRom(romIndex));
-    Memory::initMemory();
-    CPU::cpuEnabled = 1;
+    for (int i = 3; i < argc; i++) {
+        if (strncmp(argv[i], "--core=", 7) == 0) {
+            core = argv[i] + 7;
+        } else if (strncmp(argv[i], "--sd-dir=", 9) == 0) {
+            SD.setRoot(argv[i] + 9);
+        } else if (strcmp(argv[i], "--sd") == 0) {
+            useSd = true;
+        } else if (strncmp(argv[i], "--rom-frames=", 13) == 0) {
+            romFrames = atoi(argv[i] + 13);
+        } else if (strcmp(argv[i], "--spi-delay") == 0) {
+            ft81x.spiDelay = true;
+        } else if (strncmp(argv[i], "--palette=", 10) == 0) {
+            PPU::setPalette(atoi(argv[i] + 10));
+        } else if (strcmp(argv[i], "--catalog") == 0) {
+            useCatalog = true;
+        } else if (strncmp(argv[i], "--break=", 8) == 0) {
+            Debugger::addBreakpoint(strtol(argv[i] + 8, NULL, 16));
+        } else if (strncmp(argv[i], "--watch=", 8) == 0) {
+            char *type;
+            const uint16_t location = strtol(argv[i] + 8, &type, 16);
+            if (strcmp(type, ":r") == 0) {
+                Debugger::addWatchpoint(location, WATCH_READ);
+            } else if (strcmp(type, ":w") == 0) {
+                Debugger::addWatchpoint(location, WATCH_WRITE);
+            } else {
+                Debugger::addWatchpoint(location, WATCH_READ | WATCH_WRITE);
+            }
+        } else {
+            printf("Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
 
-    while (CPU::totalCycles < cycleCount) {
-        CPU::cpuStep();
-        PPU::ppuStep(ft81x);
-        SerialDataTransfer::serialStep();
+    Debugger::breakHandler = breakAndExit;
+
+    // The SD card is initialized once for the catalog and the cartridges
+    if (!SD.begin(BUILTIN_SDCARD)) {
+        printf("SD Card failed, or not present\n");
+        return 1;
+    }
+
+    // Run the ROM at the index in the catalog instead of a built in ROM
+    static char catalogPath[ROM_CATALOG_NAME_SIZE * 2];
+    if (useCatalog) {
+        RomCatalog::begin();
+        RomCatalog::printCatalog();
+        if (romPath != 0 || romIndex >= RomCatalog::getCount()) {
+            printf("There is no ROM %s in the catalog\n", argv[1]);
+            return 1;
+        }
+        RomCatalog::getPath(romIndex, catalogPath, sizeof(catalogPath));
+        romPath = catalogPath;
+    }
+
+    if (strcmp(core, "fast") == 0) {
+        run<FastCore>(romIndex, cycleCount);
+    } else if (strcmp(core, "accurate") == 0) {
+        run<AccurateCore>(romIndex, cycleCount);
+    } else if (strcmp(core, "both") == 0) {
+        const unsigned long fast = runForked<FastCore>(romIndex, cycleCount);
+        const unsigned long accurate = runForked<AccurateCore>(romIndex, cycleCount);
+        printf("\nThe accurate core took %lu%% of the time of the fast core\n", accurate * 100 / (fast + 1));
+    } else {
+        printf("Unknown core %s\n", core);
+        return 1;
+    }
+
+    if (useSd && romPath == 0) {
+        SD.remove(SD_ROM_FILE);
     }
 
     return 0;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <stdint.h>
+#include <string.h>
+#include <unistd.h>
 
 #define FT81x_COLOR_RGB(r, g, b) (((uint32_t)(r) << 16) | ((uint32_t)(g) << 8) | (uint32_t)(b))  ///< Color from RGB values
 
@@ -138,7 +140,7 @@
 
 class FT81x {
    public:
-    FT81x(int8_t cs1, int8_t cs2, int8_t dc) {}
+    FT81x(int8_t cs1, int8_t cs2, int8_t dc) : gramWrites(0), gramBytes(0), spiDelay(false), displayListSwaps(0) {}
     void begin() {}
     void clear(const uint32_t color) {}
     void drawCircle(const int16_t x, const int16_t y, const uint8_t size, const uint32_t color) {}
@@ -162,6 +164,37 @@ class FT81x {
     void swapScreen() {}
     void waitForCommandBuffer() {}
     void setRotation(const uint8_t rotation) {}
-    void writeGRAM(const uint32_t offset, const uint32_t size, const uint8_t data[]) {}
+    void writeGRAM(const uint32_t offset, const uint32_t size, const uint8_t data[]) {
+        gramWrites++;
+        gramBytes += size;
+        if (spiDelay) {
+            usleep((uint64_t)size * 8 * 1000000 / FT81x_SPI_CLOCK_SPEED);
+        }
+    }
     void loadImage(const uint32_t offset, const uint32_t size, const uint8_t data[]) {}
+
+    // Host only: the raw memory transactions the Teensy sends over SPI
+    // itself. Writes to the graphics RAM count as GRAM transfers, the
+    // display list RAM is kept and swaps are counted
+    void writeMemory(const uint32_t address, const uint32_t size, const uint8_t data[]) {
+        if (address < FT81x_ROM_FONT) {
+            writeGRAM(address, size, data);
+        } else if (address >= FT81x_RAM_DL && address + size <= FT81x_RAM_DL + sizeof(displayList)) {
+            memcpy((uint8_t *)displayList + (address - FT81x_RAM_DL), data, size);
+        } else if (address == FT81x_REG_DLSWAP) {
+            displayListSwaps++;
+        }
+    }
+    // Host only: registers read as 0. The drawing calls don't draw, so the
+    // coprocessor always leaves an empty display list
+    uint32_t readMemory32(const uint32_t address) { return 0; }
+
+    // Host only: transfers to the graphics RAM, to measure the bandwidth used
+    uint32_t gramWrites;
+    uint64_t gramBytes;
+    // Host only: take as long as the transfers would take over SPI
+    bool spiDelay;
+    // Host only: the display list RAM and how often it has been swapped in
+    uint32_t displayList[2048];
+    uint32_t displayListSwaps;
 };
\ No newline at end of file
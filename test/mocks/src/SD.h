@@ -1,6 +1,14 @@
 #pragma once
 
 #include <Arduino.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #define SD_CHIP_SELECT_PIN 1
 #define BUILTIN_SDCARD     1
@@ -8,61 +16,300 @@
 #define FILE_READ  0
 #define FILE_WRITE 1
 
+// Maximum length of host paths on the mocked SD card
+#define SD_MAX_PATH 1024
+
+// An open host file, shared by all copies of a File like on the Teensy
+// All files are mapped into memory. Files opened for writing keep their
+// descriptor to grow the file, their mapping is shared with the file, so
+// writes are plain copies into the page cache
+// Directories are listed with openNextFile
+struct SDHostFile {
+    int refs;
+    int fd;
+    uint8_t *data;
+    uint32_t size;
+    uint32_t position;
+    DIR *dir;
+    char path[SD_MAX_PATH];
+    char name[SD_MAX_PATH];
+};
+
+class File;
+// Open a file or directory by its host path
+File sdOpenHostFile(const char *path, uint8_t mode);
+
 class File {
    public:
     // File(SdFile f, const char *name);  // wraps an underlying SdFile
-    File(void) {}   // 'empty' constructor
-    ~File(void) {}  // destructor
-    virtual size_t write(uint8_t) { return 0; }
-    virtual size_t write(const uint8_t *buf, size_t size) { return size; }
-    virtual int read() { return 0; }
-    virtual int peek() { return 0; };
-    virtual int available() { return 0; }
-    virtual void flush() {}
-    int read(void *buf, uint16_t nbyte) { return 0; }
-    bool seek(uint32_t pos) { return true; }
-    uint32_t position() { return 0; }
-    uint32_t size() { return 0; }
-    void close() {}
-    operator bool() { return true; }
-    char *name();
-
-    bool isDirectory(void) { return false; }
-    File openNextFile(uint8_t mode = FILE_READ) {
-        const File file;
-        return file;
-    }
-    void rewindDirectory(void) {}
+    File(void) : file(0) {}  // 'empty' constructor
+    File(SDHostFile *file) : file(file) {}
+    File(const File &other) : file(other.file) {
+        if (file) {
+            file->refs++;
+        }
+    }
+    File &operator=(const File &other) {
+        if (other.file) {
+            other.file->refs++;
+        }
+        release();
+        file = other.file;
+        return *this;
+    }
+    ~File(void) { release(); }  // destructor
+    virtual size_t write(uint8_t data) { return write(&data, 1); }
+    virtual size_t write(const uint8_t *buf, size_t size) {
+        if (!file || file->fd < 0) {
+            return 0;
+        }
+        if (file->position + size > file->size && !resize(file->position + size)) {
+            return 0;
+        }
+        memcpy(file->data + file->position, buf, size);
+        file->position += size;
+        return size;
+    }
+    virtual int read() {
+        uint8_t data;
+        return read(&data, 1) == 1 ? data : -1;
+    }
+    virtual int peek() {
+        if (file && file->data && file->position < file->size) {
+            return file->data[file->position];
+        }
+        return -1;
+    };
+    virtual int available() { return size() - position(); }
+    virtual void flush() {
+        // Start writing the changes back without waiting for it
+        if (file && file->fd >= 0 && file->data) {
+            msync(file->data, file->size, MS_ASYNC);
+        }
+    }
+    int read(void *buf, uint16_t nbyte) {
+        if (!file) {
+            return -1;
+        }
+        const uint32_t count = (file->size - file->position) < nbyte ? (file->size - file->position) : nbyte;
+        memcpy(buf, file->data + file->position, count);
+        file->position += count;
+        return count;
+    }
+    bool seek(uint32_t pos) {
+        if (!file) {
+            return false;
+        }
+        if (pos > file->size) {
+            return false;
+        }
+        file->position = pos;
+        return true;
+    }
+    uint32_t position() { return file ? file->position : 0; }
+    uint32_t size() { return file ? file->size : 0; }
+    void close() {
+        release();
+        file = 0;
+    }
+    operator bool() { return file != 0; }
+    char *name() { return file ? file->name : 0; }
+
+    // Host only: the memory the file is mapped to
+    const uint8_t *data() { return file ? file->data : 0; }
+
+    bool isDirectory(void) { return file && file->dir; }
+    File openNextFile(uint8_t mode = FILE_READ);
+    void rewindDirectory(void) {
+        if (file && file->dir) {
+            rewinddir(file->dir);
+        }
+    }
 
     // using Print::write;
+
+   private:
+    void release() {
+        if (!file || --file->refs > 0) {
+            return;
+        }
+        if (file->data) {
+            munmap(file->data, file->size);
+        }
+        if (file->fd >= 0) {
+            ::close(file->fd);
+        }
+        if (file->dir) {
+            closedir(file->dir);
+        }
+        delete file;
+    }
+
+    // Grow a file opened for writing and map it again
+    bool resize(const uint32_t size) {
+        if (ftruncate(file->fd, size) != 0) {
+            return false;
+        }
+        if (file->data) {
+            munmap(file->data, file->size);
+        }
+        void *data = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, file->fd, 0);
+        file->data = data == MAP_FAILED ? 0 : (uint8_t *)data;
+        file->size = file->data ? size : 0;
+        return file->data != 0;
+    }
+
+    SDHostFile *file;
 };
 
+// The mocked SD card is a directory on the host, the working directory
+// unless another one is set with setRoot
 class SDClass {
    private:
+    char root[SD_MAX_PATH];
+
+    // Get the host path of a file on the card, 0 if it is too long
+    const char *hostPath(const char *filepath, char *path) {
+        const int length = snprintf(path, SD_MAX_PATH, "%s/%s", root, filepath);
+        if (length < 0 || length >= SD_MAX_PATH) {
+            return 0;
+        }
+        return path;
+    }
+
    public:
+    SDClass() { setRoot("."); }
+
+    // Host only: set the directory that backs the card
+    void setRoot(const char *dir) {
+        strncpy(root, dir, SD_MAX_PATH - 1);
+        root[SD_MAX_PATH - 1] = 0;
+    }
+
     // This needs to be called to set up the connection to the SD card
     // before other methods are used.
-    bool begin(uint8_t csPin = SD_CHIP_SELECT_PIN) { return true; }
+    bool begin(uint8_t csPin = SD_CHIP_SELECT_PIN) {
+        struct stat st;
+        return stat(root, &st) == 0 && S_ISDIR(st.st_mode);
+    }
 
     // Open the specified file/directory with the supplied mode (e.g. read or
     // write, etc). Returns a File object for interacting with the file.
     // Note that currently only one file can be open at a time.
     File open(const char *filename, uint8_t mode = FILE_READ) {
-        const File file;
-        return file;
+        char path[SD_MAX_PATH];
+        if (!hostPath(filename, path)) {
+            return File();
+        }
+        return sdOpenHostFile(path, mode);
     }
 
     // Methods to determine if the requested file path exists.
-    bool exists(const char *filepath) { return true; }
+    bool exists(const char *filepath) {
+        char path[SD_MAX_PATH];
+        return hostPath(filepath, path) && access(path, F_OK) == 0;
+    }
 
     // Create the requested directory heirarchy--if intermediate directories
     // do not exist they will be created.
-    bool mkdir(const char *filepath) { return true; }
+    bool mkdir(const char *filepath) {
+        char path[SD_MAX_PATH];
+        if (!hostPath(filepath, path)) {
+            return false;
+        }
+        for (char *c = path + strlen(root) + 1; *c; c++) {
+            if (*c == '/') {
+                *c = 0;
+                ::mkdir(path, 0755);
+                *c = '/';
+            }
+        }
+        return ::mkdir(path, 0755) == 0 || errno == EEXIST;
+    }
 
     // Delete the file.
-    bool remove(const char *filepath) { return true; }
+    bool remove(const char *filepath) {
+        char path[SD_MAX_PATH];
+        return hostPath(filepath, path) && ::remove(path) == 0;
+    }
 
-    bool rmdir(const char *filepath) { return true; }
+    bool rmdir(const char *filepath) {
+        char path[SD_MAX_PATH];
+        return hostPath(filepath, path) && ::rmdir(path) == 0;
+    }
 };
 
 extern SDClass SD;
+
+inline File sdOpenHostFile(const char *path, uint8_t mode) {
+    // Files opened for writing are created if needed and start at the end
+    const bool write = mode == FILE_WRITE;
+    const int fd = ::open(path, write ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return File();
+    }
+
+    SDHostFile *file = new SDHostFile();
+    file->refs = 1;
+    file->fd = write ? fd : -1;
+    file->data = 0;
+    file->size = 0;
+    file->position = 0;
+    file->dir = 0;
+    strncpy(file->path, path, SD_MAX_PATH - 1);
+    file->path[SD_MAX_PATH - 1] = 0;
+    const char *name = strrchr(path, '/');
+    strncpy(file->name, name ? name + 1 : path, SD_MAX_PATH - 1);
+    file->name[SD_MAX_PATH - 1] = 0;
+
+    if (S_ISDIR(st.st_mode)) {
+        ::close(fd);
+        file->fd = -1;
+        file->dir = write ? 0 : opendir(path);
+        if (!file->dir) {
+            File failed(file);
+            return File();
+        }
+        return File(file);
+    }
+
+    file->size = st.st_size;
+    file->position = write ? file->size : 0;
+    if (file->size > 0) {
+        void *data = mmap(0, file->size, write ? PROT_READ | PROT_WRITE : PROT_READ, write ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+        file->data = data == MAP_FAILED ? 0 : (uint8_t *)data;
+    }
+    // Read only files don't need the descriptor once they are mapped
+    if (!write) {
+        ::close(fd);
+    }
+    if (file->size > 0 && !file->data) {
+        File failed(file);
+        return File();
+    }
+    return File(file);
+}
+
+inline File File::openNextFile(uint8_t mode) {
+    if (!file || !file->dir) {
+        return File();
+    }
+    struct dirent *entry;
+    while ((entry = readdir(file->dir)) != 0) {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+            // Entries whose path doesn't fit can't be opened, they are
+            // skipped so the rest of the directory is still listed
+            char path[SD_MAX_PATH];
+            const int length = snprintf(path, SD_MAX_PATH, "%s/%s", file->path, entry->d_name);
+            if (length < 0 || length >= SD_MAX_PATH) {
+                continue;
+            }
+            return sdOpenHostFile(path, mode);
+        }
+    }
+    return File();
+}
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+#
+# gb.teensy Emulation Software
+# Copyright (C) 2020  Raphael Stäbler, Grant Haack
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Packs Gameboy ROMs into compressed ROM containers (.gbz) that the
+# emulator decompresses bank by bank. See lib/Cartridge/RomContainer.h
+# for the layout. Every bank is an LZ4 block, so any LZ4 block decoder
+# can read them.
+#
+# Usage: tools/gbzpack.py rom.gb [rom.gbz]
+
+import struct
+import sys
+
+BANK_SIZE = 0x4000
+HEADER_SIZE = 0x150
+MAGIC = b"GBZ1"
+
+# LZ4 block format limits
+MIN_MATCH = 4
+LAST_LITERALS = 5
+MATCH_LIMIT = 12
+MAX_OFFSET = 0xFFFF
+
+
+def write_length(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def write_sequence(out, literals, offset, match):
+    literal_length = len(literals)
+    match_length = match - MIN_MATCH if match else 0
+    out.append((min(literal_length, 15) << 4) | min(match_length, 15))
+    if literal_length >= 15:
+        write_length(out, literal_length - 15)
+    out += literals
+    if match:
+        out += struct.pack("<H", offset)
+        if match_length >= 15:
+            write_length(out, match_length - 15)
+
+
+def compress(data):
+    """Greedy LZ4 block compression with a table of the last position of every 4 byte sequence"""
+    out = bytearray()
+    size = len(data)
+    table = {}
+    anchor = 0
+    pos = 0
+    while pos < size - MATCH_LIMIT:
+        key = data[pos:pos + MIN_MATCH]
+        candidate = table.get(key)
+        table[key] = pos
+        if candidate is None or pos - candidate > MAX_OFFSET:
+            pos += 1
+            continue
+        # Extend the match forwards, the last literals have to stay literals
+        length = MIN_MATCH
+        limit = size - LAST_LITERALS - pos
+        while length < limit and data[candidate + length] == data[pos + length]:
+            length += 1
+        # and backwards into the pending literals
+        while pos > anchor and candidate > 0 and data[pos - 1] == data[candidate - 1]:
+            pos -= 1
+            candidate -= 1
+            length += 1
+        write_sequence(out, data[anchor:pos], pos - candidate, length)
+        pos += length
+        anchor = pos
+    write_sequence(out, data[anchor:], 0, 0)
+    return out
+
+
+def decompress(data, size):
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        token = data[pos]
+        pos += 1
+        length = token >> 4
+        if length == 15:
+            while True:
+                length += data[pos]
+                pos += 1
+                if data[pos - 1] != 255:
+                    break
+        out += data[pos:pos + length]
+        pos += length
+        if pos == len(data):
+            break
+        offset = data[pos] | (data[pos + 1] << 8)
+        pos += 2
+        length = token & 0xF
+        if length == 15:
+            while True:
+                length += data[pos]
+                pos += 1
+                if data[pos - 1] != 255:
+                    break
+        for _ in range(length + MIN_MATCH):
+            out.append(out[-offset])
+    return bytes(out[:size])
+
+
+def pack(rom):
+    bank_count = (len(rom) + BANK_SIZE - 1) // BANK_SIZE
+    rom = rom + b"\xff" * (bank_count * BANK_SIZE - len(rom))
+    banks = []
+    for bank in range(bank_count):
+        data = rom[bank * BANK_SIZE:(bank + 1) * BANK_SIZE]
+        packed = compress(data)
+        # Banks that don't compress are stored as they are
+        if len(packed) >= BANK_SIZE:
+            packed = data
+        elif decompress(packed, BANK_SIZE) != data:
+            sys.exit("Bank %i doesn't decompress to the original" % bank)
+        banks.append(bytes(packed))
+
+    offset = 12 + HEADER_SIZE + (bank_count + 1) * 4
+    offsets = []
+    for packed in banks:
+        offsets.append(offset)
+        offset += len(packed)
+    offsets.append(offset)
+
+    container = bytearray(MAGIC)
+    container += struct.pack("<HHI", bank_count, 0, len(rom))
+    container += rom[:HEADER_SIZE]
+    container += struct.pack("<%iI" % len(offsets), *offsets)
+    for packed in banks:
+        container += packed
+    return container
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit("Usage: gbzpack.py rom.gb [rom.gbz]")
+    source = sys.argv[1]
+    target = sys.argv[2] if len(sys.argv) > 2 else source.rsplit(".", 1)[0] + ".gbz"
+    with open(source, "rb") as f:
+        rom = f.read()
+    container = pack(rom)
+    with open(target, "wb") as f:
+        f.write(container)
+    print("%s: %i KB packed into %i KB (%i%%)" % (target, len(rom) // 1024, len(container) // 1024, len(container) * 100 // len(rom)))
+
+
+if __name__ == "__main__":
+    main()